@@ -0,0 +1,60 @@
+#ifndef LAB2_ARRIVALSORTER_H
+#define LAB2_ARRIVALSORTER_H
+
+#include "PCB.h"
+#include "PCBSource.h"
+#include "SpillFile.h"
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+//what an ArrivalSorter orders processes by
+enum SortOrder { BY_ARRIVAL, BY_PID };
+
+//hands out the processes of an unsorted source in order of arrival, processes that arrive together
+//keep the order they had in the source. sorting by pid instead is used to write reports of runs
+//whose finished processes didn't stay in memory
+//up to chunk processes are sorted in memory, a longer source is cut into sorted runs that are
+//written to temporary files and merged back as the generator asks for processes
+class ArrivalSorter : public PCBSource{
+private:
+    //one sorted run on disk and the process at its front
+    struct Run{
+        SpillFile file;
+        PCB head;
+        explicit Run(std::string dir) : file(dir) {}
+    };
+
+    PCBSource *source;
+    size_t chunk;
+    std::string tmpdir;
+    SortOrder order;
+    bool started;
+    std::vector<PCB> buffer; //the whole source when it fit in one chunk
+    size_t index;
+    std::vector<Run*> runs;
+    //front key of every run that still has processes, ties go to the earlier run
+    std::priority_queue<std::pair<int, size_t>, std::vector<std::pair<int, size_t> >, std::greater<std::pair<int, size_t> > > fronts;
+
+    void prepare();
+    void spill();
+    void sort();
+    int key(const PCB &pcb);
+
+    ArrivalSorter(const ArrivalSorter&);
+    ArrivalSorter& operator=(const ArrivalSorter&);
+public:
+    //nothing is read from src until the first call to next
+    //temporary files go in dir, or in $TMPDIR (/tmp if unset) when dir is empty
+    ArrivalSorter(PCBSource *src, size_t chunk, std::string dir, SortOrder order = BY_ARRIVAL);
+    ~ArrivalSorter();
+
+    //the first call reads all of src, throws SimError if a temporary file can't be written
+    bool next(PCB &pcb);
+
+    //how many sorted runs went to disk, 0 when everything was sorted in memory
+    size_t getruns();
+};
+
+#endif //LAB2_ARRIVALSORTER_H
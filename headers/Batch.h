@@ -0,0 +1,40 @@
+#ifndef LAB2_BATCH_H
+#define LAB2_BATCH_H
+
+#include "Simulator.h"
+#include "StatUpdater.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+//simulates many input files with the same config, each on its own, spread over the machine's cores
+//every worker keeps one Simulator and one SimResults for all the files it takes, so their buffers are reused
+class Batch{
+private:
+    struct Job{
+        std::string input;
+        std::string name;   //what its report is called in the output directory
+        long long size;     //bytes, the biggest files are started first so none is left running on its own at the end
+        SimSummary summary;
+        std::string error;  //why the file couldn't be simulated, empty if it was
+    };
+    std::vector<Job> jobs;
+    SimConfig config;
+    std::string outdir;
+
+    void worker(std::atomic<size_t> *next);
+public:
+    //list is a directory, every regular file in it is an input, or a manifest with one input path per line
+    //reports go in outdir under the input's file name, outdir is created if it isn't there
+    //throws SimError if list can't be read, outdir can't be made or two inputs have the same file name, or one is named summary
+    Batch(std::string list, std::string dir, SimConfig cfg);
+
+    //simulates every input, an input that fails is recorded in the summary and doesn't stop the rest
+    void run();
+
+    //writes one row per input and the totals over all of them, returns the number of inputs that failed
+    //throws SimError if the file can't be written
+    int print(std::string filename);
+};
+
+#endif //LAB2_BATCH_H
@@ -17,17 +17,30 @@ private:
     bool idle;
     Clock *clock;
     DList<PCB> *finished_queue; //for terminated process, used later by statupdater
+    DList<PCB> *blocked_queue;  //for processes that finished a cpu burst and have i/o next, see Phases
 
     // A vector that will act as an accumulator of all process state transitions.
-    std::vector<PCBStatus> *lcVector;
+    StatusVector *lcVector;
+
+    float busy_time; //total time spent running a process
+    int completed;   //processes terminated so far
+    std::vector<float> level_time; //time spent running processes at each mlfq level
     
     friend Dispatcher; //allows dispatcher to switch out processes
 public:
-    CPU(DList<PCB> *fq, Clock *cl, std::vector<PCBStatus> *vec);
+    CPU(DList<PCB> *fq, DList<PCB> *bq, Clock *cl, StatusVector *vec);
+    //copies get their own copy of the running process, used to snapshot a simulation
+    CPU(const CPU &other);
+    CPU& operator=(const CPU &other);
+    ~CPU();
     PCB* getpcb();
     bool isidle();
+    float getbusytime();
+    int getcompleted();
+    const std::vector<float>& getleveltime();
     void execute();
     void terminate();
+    void block();
 };
 
 #endif
\ No newline at end of file
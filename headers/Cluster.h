@@ -0,0 +1,99 @@
+#ifndef LAB2_CLUSTER_H
+#define LAB2_CLUSTER_H
+
+#include "PCB.h"
+#include "PCBSource.h"
+#include "Simulator.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum Placement {PLACE_ROUND_ROBIN, PLACE_LEAST_LOADED, PLACE_TWO_CHOICES};
+
+//simulates many machines, each with its own clock, cpu, scheduler and dispatcher, behind one placement
+//policy that picks the machine for every process as it arrives
+//the machines run in parallel a window at a time. every process arriving in a window is placed before any
+//machine simulates it, so a machine never runs ahead of what could still be sent to it, and placement
+//sees the machines' load as of the start of the window
+class Cluster{
+private:
+    //the processes placed on one machine that it hasn't taken in yet
+    class Feed : public PCBSource{
+    public:
+        std::deque<PCB> waiting;
+        bool next(PCB &pcb);
+    };
+    //counts finished processes, only read between windows, and passes everything on to the config's sink
+    class Finished : public SimSink{
+    public:
+        int count;
+        SimSink *next;
+        Finished() : count(0), next(NULL) {}
+        void finished(const PCB &pcb){count++; if(next != NULL) next->finished(pcb);}
+        void event(const PCBStatus &status){if(next != NULL) next->event(status);}
+    };
+    struct Machine{
+        Simulator sim;
+        Feed feed;
+        Finished finished;
+        SimResults results;
+        int placed;
+        bool active;   //has work, or was sent some since it last ran out
+    };
+
+    std::vector<Machine*> machines;
+    std::vector<size_t> active; //the machines the next window runs, the rest have nothing to do
+    SimConfig config;
+    Placement placement;
+    float window;
+    size_t rotation;   //next machine for round robin
+    std::mt19937 rng;  //the two machines power of two choices compares
+    typedef std::priority_queue<std::pair<int, size_t>, std::vector<std::pair<int, size_t> >, std::greater<std::pair<int, size_t> > > LoadHeap;
+    LoadHeap lightest; //machines by load for least loaded, rebuilt every window
+
+    //the worker threads wait for a window, share out the machines and report back when all of them got there
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable wake, done;
+    unsigned long long generation;
+    int waiting;       //workers done with the current window
+    bool stopping;
+    float until;
+    std::atomic<size_t> nextmachine;
+
+    int load(size_t m);
+    size_t choose();
+    void worker();
+    //runs every active machine until its clock reaches end, on all the workers, and drops the ones that ran out of work
+    void advance(float end);
+
+    Cluster(const Cluster&);
+    Cluster& operator=(const Cluster&);
+public:
+    //cfg.sink is handed every machine's results from the threads the machines run on, several at once
+    //throws SimError on fewer than one machine or a window that isn't positive
+    Cluster(int count, const SimConfig &cfg, Placement how, float windowms);
+    ~Cluster();
+
+    //places and simulates every process src produces, throws SimError if src hits an invalid record
+    void run(PCBSource *src);
+
+    //what each machine's run produced, in machine order
+    const SimResults& results(size_t machine);
+    size_t size();
+
+    //writes one row per machine and the totals over the cluster
+    void print(std::string filename);
+
+    //placement named on the command line, -1 if there is no such policy
+    static int parseplacement(std::string name);
+};
+
+#endif //LAB2_CLUSTER_H
@@ -2,7 +2,9 @@
 #define LAB2_DLIST_H
 
 #include "PCB.h"
+#include "MemoryStats.h"
 #include <clocale>
+#include <cstdlib>
 #include <iostream>
 
 template<typename T>
@@ -15,13 +17,24 @@ class DList{
         }
     };
     node *head, *tail;
+    node *spare; //unlinked nodes kept for reuse, so a DList that is refilled doesn't go back to the allocator
     int _size;
+    //node getindex returned last and its index, so stepping through the list by index is linear overall
+    node *cursor;
+    int cursor_index;
+
+    node* newnode(T data);
+    void recycle(node *n);
 public:
     DList(){
-        head = tail = NULL;
+        head = tail = spare = cursor = NULL;
         _size = 0;
+        cursor_index = 0;
     }
-    ~DList(){clear();}
+    //copies hold their own nodes, used to snapshot queues
+    DList(const DList &other);
+    DList& operator=(const DList &other);
+    ~DList();
     void add_start(T p);
     void add_end(T p);
     T* gethead();
@@ -30,25 +43,74 @@ public:
     T remove_head();
     T remove_tail();
     T removeindex(int index);
+    //item has to point into this list, as returned by gethead, gettail or getindex
+    T remove(T *item);
     int size();
     void print();
     void clear();
 };
 
+template<typename T>
+typename DList<T>::node* DList<T>::newnode(T data) {
+    if(spare == NULL){
+        MemoryStats::allocated(MEM_QUEUES, sizeof(node));
+        return new node(data);
+    }
+    node *temp = spare;
+    spare = spare->next;
+    temp->data = data;
+    temp->next = temp->prev = NULL;
+    return temp;
+}
+
+template<typename T>
+void DList<T>::recycle(node *n) {
+    n->next = spare;
+    spare = n;
+}
+
+template<typename T>
+DList<T>::DList(const DList &other) {
+    head = tail = spare = cursor = NULL;
+    _size = 0;
+    cursor_index = 0;
+    *this = other;
+}
+
+template<typename T>
+DList<T>& DList<T>::operator=(const DList &other) {
+    if(this == &other) return *this;
+    clear();
+    for(node *curr = other.head; curr != NULL; curr = curr->next) add_end(curr->data);
+    return *this;
+}
+
+template<typename T>
+DList<T>::~DList() {
+    clear();
+    while(spare != NULL){
+        node *next = spare->next;
+        delete spare;
+        MemoryStats::released(MEM_QUEUES, sizeof(node));
+        spare = next;
+    }
+}
+
 template<typename T>
 void DList<T>::add_start(T p) {
-    auto temp = new DList::node(p);
+    auto temp = newnode(p);
     if(_size > 0) head->prev = temp;
     else tail = temp;
     temp->next = head;
     temp->prev = NULL;
     head = temp;
     _size++;
+    if(cursor != NULL) cursor_index++;
 }
 
 template<typename T>
 void DList<T>::add_end(T data) {
-    auto temp = new node(data);
+    auto temp = newnode(data);
     if(_size > 0) tail->next = temp;
     else head = temp;
     temp->next = NULL;
@@ -66,12 +128,28 @@ T* DList<T>::gettail() {if(_size) return &(tail->data);}
 template <typename T>
 T* DList<T>::getindex(int index) {
     if(index < 0 || index >= _size) return NULL;
+    //start from whichever of head, tail and the last node looked up is closest
     node* curr = head;
-    while(curr != NULL && index > 0){
+    int at = 0;
+    if(_size - 1 - index < index){
+        curr = tail;
+        at = _size - 1;
+    }
+    if(cursor != NULL && abs(cursor_index - index) < abs(at - index)){
+        curr = cursor;
+        at = cursor_index;
+    }
+    while(at < index){
         curr = curr->next;
-        index--;
+        at++;
     }
-    if(curr != NULL) return &(curr->data);
+    while(at > index){
+        curr = curr->prev;
+        at--;
+    }
+    cursor = curr;
+    cursor_index = index;
+    return &(curr->data);
 }
 
 template <typename T>
@@ -83,8 +161,10 @@ T DList<T>::remove_head() {
     }
     else if(_size > 1) {
         T temp = head->data;
+        if(cursor == head) cursor = NULL;
+        else if(cursor != NULL) cursor_index--;
         head = head->next;
-        delete head->prev;
+        recycle(head->prev);
         head->prev = NULL;
         _size--;
 
@@ -101,8 +181,9 @@ T DList<T>::remove_tail() {
     }
     else if(_size > 1) {
         T temp = tail->data;
+        if(cursor == tail) cursor = NULL;
         tail = tail->prev;
-        delete tail->next;
+        recycle(tail->next);
         tail->next = NULL;
         _size--;
         return temp;
@@ -114,23 +195,39 @@ T DList<T>::removeindex(int index) {
     if(index == 0) return remove_head();
     else if(index == _size-1) return remove_tail();
     else {
-        node *curr = head;
-        while (curr != NULL && index > 0) {
-            curr = curr->next;
-            index--;
-        }
+        //walk there the same way getindex does, then leave the cursor on the node before it
+        node *curr = getindex(index) != NULL ? cursor : NULL;
         if(curr != NULL) {
+            cursor = curr->prev;
+            cursor_index = index - 1;
             curr->prev->next = curr->next;
             curr->next->prev = curr->prev;
 
             PCB temp(curr->data);
-            delete curr;
+            recycle(curr);
             _size--;
             return temp;
         }
     }
 }
 
+template <typename T>
+T DList<T>::remove(T *item) {
+    //data is the first member of a node, so the node starts where its data does
+    node *curr = reinterpret_cast<node*>(item);
+    if(curr == head) return remove_head();
+    else if(curr == tail) return remove_tail();
+    //the index of the node isn't known, so the cursor can't be kept
+    cursor = NULL;
+    curr->prev->next = curr->next;
+    curr->next->prev = curr->prev;
+
+    T temp(curr->data);
+    recycle(curr);
+    _size--;
+    return temp;
+}
+
 template <typename T>
 int DList<T>::size() {
     return _size;
@@ -141,10 +238,11 @@ void DList<T>::clear() {
     node *next = head;
     while(head != NULL){
         next = head->next;
-        delete head;
+        recycle(head);
         head = next;
     }
     tail = NULL;
+    cursor = NULL;
     _size = 0;
 }
 
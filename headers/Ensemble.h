@@ -0,0 +1,31 @@
+#ifndef LAB2_ENSEMBLE_H
+#define LAB2_ENSEMBLE_H
+
+#include "PCB.h"
+#include "Simulator.h"
+#include "StatUpdater.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+//runs the same workload under many independent random streams of a randomized policy and summarizes the spread
+//every run replays one shared, read-only copy of the parsed workload
+class Ensemble{
+private:
+    const std::vector<PCB> *workload;
+    SimConfig config;
+    int runs;
+    std::vector<SimSummary> results; //one per run, index k ran as replica k of config.seed
+
+    void worker(std::atomic<int> *next);
+public:
+    Ensemble(const std::vector<PCB> *w, SimConfig cfg, int k);
+
+    //simulates all k runs spread over the machine's cores
+    void run();
+
+    //writes mean, standard deviation and 95% confidence interval of every summary metric
+    void print(std::string filename);
+};
+
+#endif //LAB2_ENSEMBLE_H
@@ -0,0 +1,63 @@
+#ifndef LAB2_EQUIVALENCECHECK_H
+#define LAB2_EQUIVALENCECHECK_H
+
+#include "PCB.h"
+#include "PCBStatus.h"
+#include "Simulator.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+//what an engine produced for one workload, in the order it happened
+struct EngineOutput{
+    std::vector<PCB> finished;
+    std::vector<PCBStatus> events;
+};
+
+//collects what a simulation hands its sink
+class RecordingSink : public SimSink{
+public:
+    EngineOutput output;
+    void finished(const PCB &pcb){output.finished.push_back(pcb);}
+    void event(const PCBStatus &status){output.events.push_back(status);}
+};
+
+//another way of simulating a workload, which has to give exactly what Simulator::run does
+//workload is the input file's lines, for engines that go through the reader, and the processes parsed from them
+typedef void (*SimEngineRun)(const std::vector<std::string> &lines, const std::vector<PCB> &workload,
+                             const SimConfig &cfg, EngineOutput &out);
+
+//runs every engine next to the plain clock loop on random workloads and configs, and on the first difference
+//shrinks the workload to the fewest and simplest processes that still show it
+class EquivalenceCheck{
+private:
+    struct Engine{
+        std::string name;
+        SimEngineRun run;
+    };
+    std::vector<Engine> engines;
+    std::mt19937 rng;
+
+    //lines of a random input file, a few dozen processes at most so a difference is quick to shrink
+    std::vector<std::string> randomworkload();
+    SimConfig randomconfig();
+
+    //describes the first place engine and the reference differ on lines, empty if they agree
+    static std::string difference(const Engine &engine, const std::vector<std::string> &lines, const SimConfig &cfg);
+    //drops and simplifies processes of lines for as long as the difference doesn't go away
+    static std::vector<std::string> shrink(const Engine &engine, std::vector<std::string> lines, const SimConfig &cfg);
+public:
+    //starts out with the engines in this tree: input sorted in spilled runs, finished processes spilled to disk,
+    //a run resumed from a snapshot part way through and a cluster of one machine under each placement policy
+    explicit EquivalenceCheck(unsigned seed);
+
+    void addengine(std::string name, SimEngineRun run);
+
+    //checks every engine on count random cases, stopping at the first difference, which is written to report
+    //with the command that repeats it. the shrunk workload goes to reproducer
+    //returns true if every engine agreed on every case
+    bool run(int count, std::ostream &report, std::string reproducer);
+};
+
+#endif //LAB2_EQUIVALENCECHECK_H
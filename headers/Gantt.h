@@ -0,0 +1,43 @@
+#ifndef LAB2_GANTT_H
+#define LAB2_GANTT_H
+
+#include "PCBStatus.h"
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+//one stretch of time a process spent running, waiting in the ready queue or blocked on io
+struct GanttInterval{
+    int pid;
+    PROCESS_STATE state; //IN_RUNNING_QUEUE, IN_READY_QUEUE or IN_BLOCKED_QUEUE
+    float start, end;
+};
+
+//turns state transitions into intervals as they happen, so memory grows with the number of
+//transitions rather than with simulated time. intervals are appended as they close, so they come out
+//in order of their end time. zero-length intervals are dropped and a process that goes back to the
+//state it just left at the same instant keeps one interval.
+class Gantt{
+private:
+    //the state a process is in right now and the interval it last closed
+    struct Open{
+        PROCESS_STATE state;
+        float start;
+        long last; //index in intervals, -1 for none
+    };
+    std::unordered_map<int, Open> open;
+    std::vector<GanttInterval> *intervals;
+public:
+    explicit Gantt(std::vector<GanttInterval> *out);
+
+    //takes the transitions in the order they were recorded
+    void record(PCBStatus status);
+
+    //csv with one interval per line
+    static void print(std::ostream &out, const std::vector<GanttInterval> &intervals);
+    //text chart with one row per process and width columns of time, # running, - ready, ~ blocked
+    //a column shows the state at its midpoint, except that running shows in every column it overlaps
+    static void render(std::ostream &out, const std::vector<GanttInterval> &intervals, int width);
+};
+
+#endif //LAB2_GANTT_H
@@ -0,0 +1,36 @@
+#ifndef LAB2_GROUPS_H
+#define LAB2_GROUPS_H
+
+#include <map>
+#include <string>
+
+//what a group is allowed under group fair share
+struct GroupShare{
+    float shares;  //weight against the other groups, cpu time is split between busy groups in proportion to it
+    float quota;   //ms of cpu time per period before the group is throttled until the next one, 0 for no limit
+    float period;  //ms, periods start at multiples of it
+
+    GroupShare() : shares(1024), quota(0), period(100) {}
+};
+
+//what a group got out of a run
+struct GroupStats{
+    int group;
+    GroupShare share;
+    float cpu_time;
+    float throttled_time; //time spent throttled while it had processes waiting to run
+    int throttles;
+    int finished;
+    double wait, turn, resp; //totals over its finished processes
+
+    GroupStats() : group(0), cpu_time(0), throttled_time(0), throttles(0), finished(0), wait(0), turn(0), resp(0) {}
+};
+
+//the --groups file, one group per line: Group Shares [Quota [Period]]
+class Groups{
+public:
+    //throws SimError if the file can't be read or a line isn't a valid group
+    static std::map<int, GroupShare> read(std::string filename);
+};
+
+#endif //LAB2_GROUPS_H
@@ -0,0 +1,60 @@
+#ifndef LAB2_MEMORYSTATS_H
+#define LAB2_MEMORYSTATS_H
+
+#include <cstddef>
+#include <iostream>
+#include <new>
+#include <string>
+
+//the structures that grow with the size of a run, each one's bytes are counted separately
+enum MemorySubsystem {
+    MEM_QUEUES,         //DList nodes of the ready, blocked and finished queues, spare nodes included
+    MEM_PCBS,           //PCBs on the heap, the one on the cpu and the ones the dispatcher swaps in
+    MEM_LIFECYCLE,      //the state changes kept for the lifecycle report
+    MEM_LIFECYCLE_PRINT,//the table the lifecycle report is built in
+    MEM_VALIDATOR,      //pids seen so far by PCBValidator
+    MEM_PHASES,         //bursts of processes whose phases are listed in the input
+    MEM_SUBSYSTEMS
+};
+
+//live and peak bytes per subsystem for the whole process, shared by every simulation running in it
+//counting is a couple of atomic operations per allocation, the structures above allocate in bulk or reuse
+class MemoryStats {
+public:
+    static void allocated(MemorySubsystem s, size_t bytes);
+    static void released(MemorySubsystem s, size_t bytes);
+    static size_t live(MemorySubsystem s);
+    static size_t peak(MemorySubsystem s);
+    //peak resident set size of the process in bytes, 0 if the system doesn't report it
+    static size_t peakrss();
+    static std::string name(MemorySubsystem s);
+    //table of every subsystem followed by the peak rss
+    static void print(std::ostream &out);
+};
+
+//allocator for standard containers that charges what they allocate to subsystem S
+template<typename T, int S>
+struct CountingAllocator {
+    typedef T value_type;
+    template<typename U> struct rebind { typedef CountingAllocator<U, S> other; };
+
+    CountingAllocator() {}
+    template<typename U> CountingAllocator(const CountingAllocator<U, S>&) {}
+
+    T* allocate(size_t n) {
+        T *p = static_cast<T*>(::operator new(n * sizeof(T)));
+        MemoryStats::allocated(MemorySubsystem(S), n * sizeof(T));
+        return p;
+    }
+    void deallocate(T *p, size_t n) {
+        MemoryStats::released(MemorySubsystem(S), n * sizeof(T));
+        ::operator delete(p);
+    }
+};
+
+template<typename T, typename U, int S>
+bool operator==(const CountingAllocator<T, S>&, const CountingAllocator<U, S>&) { return true; }
+template<typename T, typename U, int S>
+bool operator!=(const CountingAllocator<T, S>&, const CountingAllocator<U, S>&) { return false; }
+
+#endif //LAB2_MEMORYSTATS_H
@@ -2,17 +2,46 @@
 #define LAB2_PCB_H
 
 #include <iostream>
+#include "MemoryStats.h"
+
+//where the rest of a multi-phase process's cpu and i/o bursts come from, see Phases
+//only this much is kept per process however many phases it has
+struct PhaseState{
+    int left;      //cpu bursts still to come after the current one, 0 for a process with a single burst
+    int cpu, io;   //mean cpu and i/o burst of generated phases, cpu is -1 when the bursts are listed
+    unsigned next; //generator state of generated phases
+    const int *listed; //next listed i/o burst, in the PhaseTable of whatever read the process
+};
 
 //data structure to hold process information
 struct PCB{
     int pid, arrival, burst, priority, num_context;
+    int deadline; //absolute time the process should be finished by, -1 when it has none
+    int level;    //multi-level feedback queue level, 0 is the highest
+    int group;    //group fair share group the process belongs to, 0 when the input has none
     // We add a float variable to capture the I/O burst time of a process.
     float time_left, resp_time, wait_time, finish_time, io_burst;
     bool started;
+    PhaseState phases;
 
-    PCB(){pid = arrival = burst = time_left = priority = resp_time = wait_time = num_context = finish_time = started = io_burst= 0;}
-    PCB(int id, int arr, int time, int prio, int io_burst) : pid(id), arrival(arr), burst(time), time_left(time), priority(prio), io_burst(io_burst) {
+    PCB(){pid = arrival = burst = time_left = priority = resp_time = wait_time = num_context = finish_time = started = io_burst= 0; deadline = -1; level = 0; group = 0; phases.left = phases.cpu = phases.io = phases.next = 0; phases.listed = NULL;}
+    PCB(int id, int arr, int time, int prio, int io_burst, int deadline_ = -1) : pid(id), arrival(arr), burst(time), priority(prio), deadline(deadline_), time_left(time), io_burst(io_burst) {
         resp_time = wait_time = num_context = finish_time = started = 0;
+        level = 0;
+        group = 0;
+        phases.left = phases.cpu = phases.io = phases.next = 0;
+        phases.listed = NULL;
+    }
+    //PCBs on the heap are the ones on the cpu, counted under MEM_PCBS
+    static void* operator new(size_t size){
+        void *p = ::operator new(size);
+        MemoryStats::allocated(MEM_PCBS, size);
+        return p;
+    }
+    static void operator delete(void *p, size_t size){
+        if(p == NULL) return;
+        MemoryStats::released(MEM_PCBS, size);
+        ::operator delete(p);
     }
     void print(){
         std::cout << pid << " " << arrival << " " << time_left << " " << priority << std::endl;
@@ -0,0 +1,44 @@
+#ifndef LAB2_PCBREADER_H
+#define LAB2_PCBREADER_H
+
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "PCB.h"
+#include "PCBSource.h"
+#include "PCBValidator.h"
+#include "Phases.h"
+#include "SimError.h"
+
+//parses and validates process records from an input file, one line per process
+//throws SimError on a record that is malformed or fails validation
+//processes with listed phases point into the reader's PhaseTable, whoever keeps them past the reader keeps phases() too
+class PCBReader : public PCBSource{
+private:
+    std::ifstream infile;
+    // where records are actually read from, either infile or std::cin when the filename is "-"
+    std::istream *input;
+    PCBValidator validator;
+    bool ordered, unique;
+    std::shared_ptr<PhaseTable> table;
+public:
+    explicit PCBReader(std::string filename);
+    //reads from a stream the caller owns, e.g. a std::istringstream of records already in memory
+    explicit PCBReader(std::istream &in);
+
+    //accepts records in any order of arrival, for input that goes through an ArrivalSorter
+    void allowunsorted();
+    //leaves duplicate pids to whoever sorts the finished processes by pid, so the reader doesn't keep every pid
+    void skippidcheck();
+
+    //where the listed bursts of the processes read so far are kept
+    std::shared_ptr<PhaseTable> phases();
+
+    //reads the next record, blocks on a pipe/FIFO until the producer writes it or closes its end
+    bool next(PCB &pcb);
+};
+
+#endif //LAB2_PCBREADER_H
@@ -0,0 +1,39 @@
+#ifndef LAB2_PCBSOURCE_H
+#define LAB2_PCBSOURCE_H
+
+#include "PCB.h"
+#include <vector>
+
+//anything PCBGenerator can pull processes from, in order of arrival
+class PCBSource{
+public:
+    virtual ~PCBSource(){}
+
+    //fills pcb with the next process, returns false once no more processes are coming
+    virtual bool next(PCB &pcb) = 0;
+
+    //pulls every remaining process into workload so it can be shared between simulations
+    void readall(std::vector<PCB> &workload){
+        PCB pcb;
+        while(next(pcb)) workload.push_back(pcb);
+    }
+};
+
+//replays a workload that was already parsed into memory
+//the vector is only read, so any number of simulations can share one copy
+//nothing is checked here, the workload should come from PCBReader or have been through PCBValidator
+class WorkloadSource : public PCBSource{
+private:
+    const std::vector<PCB> *workload;
+    size_t index;
+public:
+    //start skips that many processes, for resuming part way through
+    explicit WorkloadSource(const std::vector<PCB> *w, size_t start = 0) : workload(w), index(start) {}
+    bool next(PCB &pcb){
+        if(index >= workload->size()) return false;
+        pcb = (*workload)[index++];
+        return true;
+    }
+};
+
+#endif //LAB2_PCBSOURCE_H
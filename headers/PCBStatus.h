@@ -2,6 +2,8 @@
 #define LAB2_PCBSTATUS_H
 #include <stdio.h>
 #include <iostream>
+#include <vector>
+#include "MemoryStats.h"
 
 // An enum to keep track of the process lifecycle throughout the
 // scheduler simulation. As the state of the process changes, we will 
@@ -90,4 +92,7 @@ public:
     }
 };
 
+//how the simulation keeps its state changes, counted under MEM_LIFECYCLE
+typedef std::vector<PCBStatus, CountingAllocator<PCBStatus, MEM_LIFECYCLE> > StatusVector;
+
 #endif //LAB2_PCBSTATUS_H
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef LAB2_PCBVALIDATOR_H
+#define LAB2_PCBVALIDATOR_H
+
+#include "PCB.h"
+#include "MemoryStats.h"
+#include "SimError.h"
+#include <unordered_set>
+#include <vector>
+
+//the checks every process has to pass before it is simulated, shared by file input and in-memory workloads
+//processes are checked one at a time, in the order they will be simulated
+class PCBValidator{
+private:
+    int last_arr;
+    bool ordered; //whether arrivals have to come in order
+    bool unique;  //whether pids are checked for duplicates here
+    //pids seen so far, grows with the number of processes rather than with how large their pids are
+    std::unordered_set<int, std::hash<int>, std::equal_to<int>, CountingAllocator<int, MEM_VALIDATOR> > pids;
+public:
+    //ordered=false skips the arrival order check, for input that gets sorted afterwards
+    //unique=false skips the duplicate pid check, which keeps every pid, for runs that catch duplicates later
+    explicit PCBValidator(bool ordered = true, bool unique = true);
+
+    //throws SimError if pcb can't follow the processes checked before it
+    void check(const PCB &pcb);
+
+    //checks a whole workload from the start
+    static void check(const std::vector<PCB> &workload);
+};
+
+#endif //LAB2_PCBVALIDATOR_H
@@ -0,0 +1,51 @@
+#ifndef LAB2_PHASES_H
+#define LAB2_PHASES_H
+
+#include "PCB.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//the listed bursts of the processes one input was read into, freed with the table
+//a process's bursts sit together in a block that never moves once allocated, so a simulation can read them
+//without a lock while the reader appends more, as long as the process reached it after its bursts were added
+//through the same thread or a queue that orders the two. processes read into a table can't outlive it.
+class PhaseTable{
+private:
+    std::vector<int*> blocks;
+    size_t used;  //of the last block
+    size_t size;  //of the last block, a list longer than a block gets one to itself
+    size_t total; //ints in every block, for MemoryStats
+
+    PhaseTable(const PhaseTable&);
+    PhaseTable& operator=(const PhaseTable&);
+public:
+    PhaseTable();
+    ~PhaseTable();
+
+    //copies bursts into the table and returns where they start
+    const int* add(const std::vector<int> &bursts);
+};
+
+//processes that alternate between cpu and i/o bursts instead of having one of each
+//in the input the CPU burst column either lists them, cpu,io,cpu,...,cpu, or asks for them to be
+//generated, gN:C:I for N cpu bursts averaging C ms with i/o bursts averaging I ms between them.
+//listed bursts go in a PhaseTable owned by whatever read them. generated ones are drawn from the
+//few bytes of PhaseState in the PCB as they are needed, so a process can have millions of phases
+//without any of them being stored.
+class Phases{
+public:
+    //sets pcb's first cpu burst and the state for the rest from a CPU burst column, a listed process's bursts go in table
+    //returns false if the column is a plain number, throws SimError if it is a malformed list or generator
+    static bool parse(const std::string &column, PCB &pcb, PhaseTable &table);
+
+    //moves pcb on to its next i/o burst and the cpu burst after it, adding that to pcb.burst
+    //returns false if it has none left
+    static bool advance(PCB &pcb);
+
+    //appends what identifies the bursts pcb still has to go through, for hashing and comparing workloads
+    static void fingerprint(const PCB &pcb, std::vector<int> &out);
+    static bool same(const PCB &a, const PCB &b);
+};
+
+#endif //LAB2_PHASES_H
@@ -0,0 +1,57 @@
+#ifndef LAB2_PIPELINE_H
+#define LAB2_PIPELINE_H
+
+#include "PCB.h"
+#include "PCBSource.h"
+#include "PCBStatus.h"
+#include "Phases.h"
+#include "SPSCRing.h"
+#include "Simulator.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+//pulls processes off the ring the reader thread fills
+class RingSource : public PCBSource{
+private:
+    SPSCRing<PCB> *ring;
+public:
+    explicit RingSource(SPSCRing<PCB> *r) : ring(r) {}
+    bool next(PCB &pcb){return ring->pop(pcb);}
+};
+
+//one item for the writer thread, either a finished process or a state transition
+struct SimOutput{
+    bool isfinished;
+    PCB pcb;
+    PCBStatus status;
+};
+
+//runs parsing, simulation and reporting as three stages on three threads connected by rings
+//the report lists processes in the order they finished, followed by the usual averages,
+//and the state transitions go to outfile-events one per line as they happen
+class Pipeline : public SimSink{
+private:
+    SPSCRing<PCB> input;
+    SPSCRing<SimOutput> output;
+    std::atomic<bool> readfailed;
+    std::string readerror; //what the reader failed on, only read after it has been joined
+    std::shared_ptr<PhaseTable> phases; //the reader's listed bursts, the reader thread can finish well before the simulation
+    //group fair share's per-group usage, set before the output ring is closed so the writer sees it once it is
+    std::vector<GroupStats> groupusage;
+
+    void readinput(std::string infile);
+    void writeoutput(std::string outfile, SimConfig cfg);
+public:
+    explicit Pipeline(size_t capacity);
+
+    //the simulation stage runs on the calling thread, throws SimError if the input had an invalid record,
+    //in which case the simulation stops there and no report is written
+    void run(std::string infile, std::string outfile, const SimConfig &cfg);
+
+    void finished(const PCB &pcb);
+    void event(const PCBStatus &status);
+};
+
+#endif //LAB2_PIPELINE_H
@@ -0,0 +1,51 @@
+#ifndef LAB2_PROGRESS_H
+#define LAB2_PROGRESS_H
+
+#include "PCB.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+//where a run in progress can be watched from outside the program
+//the simulation thread stores the latest numbers with plain atomic stores once a cycle and never waits on
+//anything, a server thread answers every connection to a unix socket with them, one "name value" per line
+class Progress{
+private:
+    std::atomic<float> time;
+    std::atomic<int> arrived, completed, ready, blocked, running;
+    std::atomic<float> avg_wait, avg_turn, avg_resp;
+    std::atomic<bool> finished;
+    //only touched by the simulation thread, the averages above are worked out from them
+    double wait, turn, resp;
+    int count;
+    std::chrono::steady_clock::time_point started;
+
+    std::string path;
+    int listener;
+    std::atomic<bool> stopping;
+    std::thread server;
+
+    void serve();
+
+    Progress(const Progress&);
+    Progress& operator=(const Progress&);
+public:
+    Progress();
+    //stops answering and removes the socket
+    ~Progress();
+
+    //starts answering connections to a unix socket at socketpath, replacing whatever file was there
+    //throws SimError if the socket can't be made
+    void listen(std::string socketpath);
+
+    //called by the simulation thread
+    void processfinished(const PCB &pcb);
+    void update(float now, int emitted, int done, int readyqueue, int blockedqueue, bool busy);
+    void end();
+
+    //the lines a connection gets
+    std::string report();
+};
+
+#endif //LAB2_PROGRESS_H
@@ -0,0 +1,50 @@
+#ifndef LAB2_QUANTUMOPTIMIZER_H
+#define LAB2_QUANTUMOPTIMIZER_H
+
+#include "PCB.h"
+#include "Simulator.h"
+#include <atomic>
+#include <map>
+#include <string>
+#include <vector>
+
+//searches for the time quantum that minimizes an objective for RR, PP or PR
+//a coarse geometric grid finds the neighbourhood of the best quantum, then the gaps on either side of
+//the best one found so far are bisected, with the probes of a round spread over the cores, until the
+//whole quanta next to it have been tried. all evaluations replay one parsed copy of the workload.
+//a single preemptive random run is too noisy to rank quanta on, so it is scored over several replicas
+//of the seed, the same ones for every quantum, the way an Ensemble runs them.
+class QuantumOptimizer{
+private:
+    const std::vector<PCB> *workload;
+    SimConfig config;
+    int objective;
+    int maxq;
+    int replicas; //runs averaged per quantum, more than one only for preemptive random
+    int threads;
+    std::map<int, double> scores; //every quantum evaluated so far and its objective value
+    std::vector<Simulator*> sims; //one per worker thread, kept between rounds
+
+    void evaluate(std::vector<int> quanta);
+    void worker(int t, const std::vector<int> *quanta, std::vector<double> *out, std::atomic<int> *next);
+    double score(const SimResults &res);
+public:
+    enum {WAIT, TURNAROUND, P99_TURNAROUND, RESPONSE, SWITCHES};
+
+    //objective from its command line name: wait, turnaround, p99, response or switches, -1 if unknown
+    static int parseobjective(std::string name);
+    static std::string objectivename(int obj);
+
+    //quanta 1..max are searched, max <= 0 means the longest burst in the workload
+    //preemptive random scores each quantum by the mean over reps independent runs, reps <= 0 means 10
+    QuantumOptimizer(const std::vector<PCB> *w, SimConfig cfg, int obj, int max, int reps);
+    ~QuantumOptimizer();
+
+    //returns the best quantum, ties go to the smaller one
+    int run();
+
+    //writes every quantum that was evaluated with its objective value and the best one
+    void print(std::string filename);
+};
+
+#endif //LAB2_QUANTUMOPTIMIZER_H
@@ -0,0 +1,32 @@
+#ifndef LAB2_RESULTCACHE_H
+#define LAB2_RESULTCACHE_H
+
+#include "PCB.h"
+#include "Simulator.h"
+#include <string>
+#include <vector>
+
+//on-disk cache of report files, keyed by a hash of the parsed workload and the settings that affect the result
+//entries are written to a temporary name and renamed into place, so concurrent runs sharing a
+//directory only ever see complete entries and the worst case of a race is simulating twice
+class ResultCache{
+private:
+    std::string dir;
+
+    std::string path(std::string key, std::string kind);
+    static bool copyfile(std::string from, std::string to);
+public:
+    //creates dir if it doesn't exist yet
+    explicit ResultCache(std::string directory);
+
+    //64-bit FNV-1a over every process's fields, the algorithm, quantum, seed (preemptive random only) and SCHEDSIM_VERSION
+    static std::string key(const std::vector<PCB> &workload, const SimConfig &cfg);
+
+    //copies a cached report and lifecycle to outfile and outfile-lifecycle, false on a miss
+    bool fetch(std::string key, std::string outfile);
+
+    //saves the report and lifecycle a run just wrote to outfile
+    void store(std::string key, std::string outfile);
+};
+
+#endif //LAB2_RESULTCACHE_H
@@ -0,0 +1,80 @@
+#ifndef LAB2_SPSCRING_H
+#define LAB2_SPSCRING_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//bounded lock-free queue between exactly one producer thread and one consumer thread
+//the producer closes it when it is done, the consumer then drains what is left
+template<typename T>
+class SPSCRing{
+private:
+    std::vector<T> buffer;
+    size_t mask;
+    // indices only ever grow; each is written by one side and read by the other.
+    // kept on separate cache lines so the two threads don't fight over one.
+    alignas(64) std::atomic<size_t> head; //next slot to read, owned by the consumer
+    alignas(64) std::atomic<size_t> tail; //next slot to write, owned by the producer
+    alignas(64) std::atomic<bool> closed;
+public:
+    //capacity is rounded up to a power of two
+    explicit SPSCRing(size_t capacity);
+
+    //producer side, push waits while the ring is full
+    bool trypush(const T &item);
+    void push(const T &item);
+    void close();
+
+    //consumer side, pop waits while the ring is empty and returns false once it is closed and drained
+    bool trypop(T &item);
+    bool pop(T &item);
+};
+
+template<typename T>
+SPSCRing<T>::SPSCRing(size_t capacity) : head(0), tail(0), closed(false) {
+    size_t size = 1;
+    while(size < capacity) size <<= 1;
+    buffer.resize(size);
+    mask = size - 1;
+}
+
+template<typename T>
+bool SPSCRing<T>::trypush(const T &item) {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if(t - head.load(std::memory_order_acquire) > mask) return false;
+    buffer[t & mask] = item;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+void SPSCRing<T>::push(const T &item) {
+    while(!trypush(item)) std::this_thread::yield();
+}
+
+template<typename T>
+void SPSCRing<T>::close() {
+    closed.store(true, std::memory_order_release);
+}
+
+template<typename T>
+bool SPSCRing<T>::trypop(T &item) {
+    size_t h = head.load(std::memory_order_relaxed);
+    if(h == tail.load(std::memory_order_acquire)) return false;
+    item = buffer[h & mask];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+bool SPSCRing<T>::pop(T &item) {
+    while(!trypop(item)){
+        // check closed before the final attempt so an item pushed right before close isn't lost.
+        if(closed.load(std::memory_order_acquire)) return trypop(item);
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+#endif //LAB2_SPSCRING_H
@@ -0,0 +1,50 @@
+#ifndef LAB2_SCHEDSIM_H
+#define LAB2_SCHEDSIM_H
+
+// Entry point for embedding the simulator (libschedsim.a) in another program.
+// Results come back in memory; nothing is written to disk unless SimConfig::outfile is set.
+// A workload that can't be simulated throws SimError, nothing is printed.
+//
+//   std::vector<PCB> workload;           // fill directly, or with PCBReader::readall, keeping
+//                                        // PCBReader::phases while the workload is in use
+//   SimConfig config;
+//   config.algorithm = 2; config.timeq = 4;
+//   SimResults res = simulate(workload, config);
+//
+// Callers in a tight loop should keep their own Simulator and SimResults and call
+// Simulator::run, which reuses both between calls.
+
+#include "PCB.h"
+#include "PCBReader.h"
+#include "SpillFile.h"
+#include "ArrivalSorter.h"
+#include "TraceImporter.h"
+#include "PCBSource.h"
+#include "PCBValidator.h"
+#include "Phases.h"
+#include "Groups.h"
+#include "SimError.h"
+#include "MemoryStats.h"
+#include "Simulator.h"
+#include "StatUpdater.h"
+#include "Telemetry.h"
+#include "Gantt.h"
+#include "Ensemble.h"
+#include "Pipeline.h"
+#include "ResultCache.h"
+#include "QuantumOptimizer.h"
+#include "WhatIf.h"
+#include "Cluster.h"
+#include "EquivalenceCheck.h"
+#include "Batch.h"
+#include "Progress.h"
+#include <vector>
+
+//simulates workload with one Simulator per calling thread, so buffers are reused across
+//calls without any state being shared between threads
+inline SimResults simulate(const std::vector<PCB> &workload, const SimConfig &config){
+    static thread_local Simulator sim;
+    return sim.simulate(workload, config);
+}
+
+#endif //LAB2_SCHEDSIM_H
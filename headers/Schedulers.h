@@ -3,7 +3,14 @@
 
 #include "DList.h"
 #include "CPU.h"
+#include "Groups.h"
 #include <vector>
+#include <queue>
+#include <deque>
+#include <map>
+#include <random>
+#include <set>
+#include <unordered_map>
 #include "PCBStatus.h"
 
 class CPU;
@@ -17,32 +24,116 @@ private:
     DList<PCB> *blocked_queue;
     Clock *clock;
     bool _interrupt;
+    bool _preempt;
+    int switches; //context switches performed so far
 
     // A vector of process states to keep track of the state changes throughout the simulation.
-    std::vector<PCBStatus> *lcVector;
+    StatusVector *lcVector;
 public:
     Dispatcher();
-    Dispatcher(CPU *cp, Scheduler *sch, DList<PCB> *rq, Clock *cl, DList<PCB> *bq, std::vector<PCBStatus> *lifeCycleVector);
+    Dispatcher(CPU *cp, Scheduler *sch, DList<PCB> *rq, Clock *cl, DList<PCB> *bq, StatusVector *lifeCycleVector);
     PCB* switchcontext(int index);
+    //sends a process taken off the cpu to the blocked queue if it has i/o left, otherwise to the ready queue
+    void requeue(PCB *old_pcb);
     void execute();
     void interrupt();
+    //takes the running process off the cpu without loading another one, for group fair share to throttle it
+    void preempt();
+    int getswitches();
+};
+
+//a process in the ready queue as earliest deadline first sees it, ties go to whichever was queued first
+struct DeadlineEntry{
+    int deadline;
+    long order;
+    PCB *pcb; //points into the ready queue
+    bool operator>(const DeadlineEntry &other) const {
+        return deadline != other.deadline ? deadline > other.deadline : order > other.order;
+    }
+};
+
+//a group as group fair share sees it
+struct GroupState{
+    GroupShare share;
+    std::deque<PCB*> ready; //its processes in the ready queue, in the order they got there
+    double vruntime;        //cpu time it has had divided by its shares
+    float used;             //cpu time in the current period
+    float periodstart;
+    float since, release;   //when it was throttled and when it gets its quota back
+    float stalled;          //since when a throttled group has had processes waiting, -1 while it has none
+    bool queued;            //in the runnable set
+    bool throttled;
 };
 
 class Scheduler{
 private:
     int next_pcb_index;
+    PCB *next_pcb; //set instead of the index when the scheduler already holds the process
     DList<PCB> *ready_queue;
     CPU *cpu;
     Dispatcher *dispatcher;
     int algorithm;
     float timeq, timer; //time quantum, timer to keep track of when to interrupt dispatcher
-    std::vector<PCBStatus> *lcVector;
+    StatusVector *lcVector;
+    std::mt19937 rng; //owned per scheduler so concurrent simulations don't share rand()'s state
+
+    //earliest deadline first, the multi-level feedback queue and group fair share keep their own index of the
+    //ready queue. everything reaches it through add_end, so the ones not indexed yet are always the last size - known.
+    int known;
+
+    //ready processes by deadline for earliest deadline first
+    std::priority_queue<DeadlineEntry, std::vector<DeadlineEntry>, std::greater<DeadlineEntry> > deadlines;
+    long queued;
+
+    //ready processes by level for the multi-level feedback queue, bit k of nonempty is set when level k
+    //has any, so the highest waiting level is found in one instruction however many processes are ready
+    std::vector<std::deque<PCB*> > levels;
+    std::vector<float> quanta; //quantum of each level, highest level first
+    unsigned long long nonempty;
+    float boost, sinceboost;   //every boost ms everything goes back to level 0, 0 for never
+
+    //groups for group fair share. the ones with ready processes that aren't throttled are kept by virtual runtime,
+    //so the group furthest behind its share is found in O(log g), and throttled ones by when they get their
+    //quota back, so only the groups whose period comes round are looked at
+    Clock *clock;
+    std::map<int, GroupShare> shares;
+    std::unordered_map<int, size_t> groupindex;
+    std::vector<GroupState> groups;
+    std::vector<GroupStats> groupusage;
+    std::set<std::pair<double, size_t> > runnable;
+    std::priority_queue<std::pair<float, size_t>, std::vector<std::pair<float, size_t> >, std::greater<std::pair<float, size_t> > > releases;
+    double minvruntime; //least virtual runtime a group starts from when it becomes runnable, so an idle group can't bank time
+    int charging;  //group of the process on the cpu, -1 for none
+    float pending; //cpu time charging has had that isn't in its virtual runtime yet
+
+    //hands whatever joined the end of the ready queue since the last cycle to insert, in the order it joined
+    void indexnew(void (Scheduler::*insert)(PCB*));
+    //runs pcb next, the dispatcher takes it out of the ready queue this cycle
+    void picked(PCB *pcb);
+    void insertdeadline(PCB *pcb);
+    void insertlevel(PCB *pcb);
+    void insertgroup(PCB *pcb);
+    void boostlevels();
+    size_t findgroup(int group);
+    void activate(size_t g);
+    void settle();
+    void charge(size_t g);
 public:
     Scheduler();
     Scheduler(DList<PCB> *rq, CPU *cp, int alg);
-    Scheduler(DList<PCB> *rq, CPU *cp, int alg, int tq,std::vector<PCBStatus> *lifeCycleVector);
+    Scheduler(DList<PCB> *rq, CPU *cp, int alg, int tq,StatusVector *lifeCycleVector);
     void setdispatcher(Dispatcher *disp);
+    void setseed(unsigned seed, unsigned replica);
+    //levels for the multi-level feedback queue, at most 64, each with its own quantum
+    void setlevels(const std::vector<float> &quanta, float boost);
+    //shares and quotas for group fair share by group, groups that aren't listed get GroupShare's defaults
+    void setgroups(const std::map<int, GroupShare> &config, Clock *cl);
+    //cpu time, throttled time and throttles of every group seen so far, finished and latencies are left at 0
+    const std::vector<GroupStats>& getgroupusage();
     int getnext();
+    PCB* getnextpcb();
+    //forgets the deadline heap, has to be called when the ready queue is replaced as a whole
+    void reindex();
     void execute();
     void fcfs();
     void srtf();
@@ -50,6 +141,9 @@ public:
     void pp();
     // adding a new method for preemptive random.
     void pr();
+    void edf();
+    void mlfq();
+    void gfs();
 };
 
 #endif //LAB2_SCHEDULER_H
@@ -0,0 +1,14 @@
+#ifndef LAB2_SIMERROR_H
+#define LAB2_SIMERROR_H
+
+#include <stdexcept>
+#include <string>
+
+//thrown for a workload the simulator can't run, what() says which check it failed
+//nothing is printed, it's up to the caller to report it
+class SimError : public std::runtime_error{
+public:
+    explicit SimError(const std::string &what) : std::runtime_error(what) {}
+};
+
+#endif //LAB2_SIMERROR_H
@@ -0,0 +1,154 @@
+#ifndef LAB2_SIMULATOR_H
+#define LAB2_SIMULATOR_H
+
+#include "DList.h"
+#include "PCB.h"
+#include "PCBSource.h"
+#include "PCBStatus.h"
+#include "Clock.h"
+#include "StatUpdater.h"
+#include "Telemetry.h"
+#include "Gantt.h"
+#include "SpillFile.h"
+#include "Progress.h"
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+//bump whenever a change alters what a simulation produces, cached results from older versions are then ignored
+#define SCHEDSIM_VERSION "1.3"
+
+//gets results handed to it while the simulation is still running
+class SimSink{
+public:
+    virtual ~SimSink(){}
+    virtual void finished(const PCB &pcb) = 0;
+    virtual void event(const PCBStatus &status) = 0;
+};
+
+//everything a run needs besides the workload itself
+struct SimConfig{
+    int algorithm;
+    int timeq;            //-1 when the algorithm doesn't take a quantum
+    unsigned seed;        //seed for the scheduler's generator, only preemptive random draws from it
+    unsigned replica;     //tells apart independent runs under the same seed, e.g. the runs of an ensemble
+    std::string outfile;  //where the report and lifecycle files go, empty to skip writing them
+    std::ostream *stream; //per-process rows as they finish, NULL for none
+    bool lifecycle;       //copy the state transitions into the results
+    float telemetry;      //sampling interval in ms for queue depths and utilization, 0 for none
+    std::ostream *telemetry_stream; //telemetry rows as they are sampled, NULL to keep them in the results
+    bool gantt;           //record running/ready/blocked intervals, written to outfile-gantt and outfile-gantt-chart
+    SimSink *sink;        //finished processes and state transitions at the end of every cycle, NULL for none
+    //when > 0 finished processes go to a temporary file instead of staying in memory, and the report is
+    //sorted by pid this many processes at a time. results.finished stays empty, no lifecycle file is
+    //written and stream, snapshot and restore can't be used
+    size_t spill;
+    //quantum of each multi-level feedback queue level, highest first, at most 64. empty for three levels
+    //of timeq, 2 * timeq and 4 * timeq
+    std::vector<float> levels;
+    float boost;          //ms between moving every process back to the top level, 0 for never
+    //shares and quotas for group fair share by group, groups that aren't in it get GroupShare's defaults
+    std::map<int, GroupShare> groups;
+    Progress *progress;   //gets the run's time, queue depths and averages every cycle, NULL for none
+
+    SimConfig(){algorithm = 0; timeq = -1; seed = 0; replica = 0; stream = NULL; lifecycle = false; telemetry = 0; telemetry_stream = NULL; gantt = false; sink = NULL; spill = 0; boost = 0; progress = NULL;}
+};
+
+//everything a run produced, kept in memory
+struct SimResults{
+    SimSummary summary;
+    std::vector<PCB> finished;        //every process, in the order they finished
+    std::vector<PCBStatus> lifecycle; //only filled in when SimConfig::lifecycle is set, in order of time
+    TelemetrySeries telemetry;        //only filled in when SimConfig::telemetry is set and not streamed
+    std::vector<GanttInterval> gantt; //only filled in when SimConfig::gantt is set, in order of their end time
+};
+
+struct SimEngine;
+
+//the state of a simulation part way through, taken by Simulator::snapshot and resumed by Simulator::restore
+struct SimSnapshot{
+    SimEngine *engine;
+    DList<PCB> ready_queue;
+    DList<PCB> blocked_queue;
+    int finished;  //length of the finished queue, nothing before it changes once it is there
+    int emitted;   //processes the source had handed out
+    float time;
+
+    SimSnapshot() : engine(NULL), finished(0), emitted(0), time(0) {}
+    ~SimSnapshot();
+private:
+    SimSnapshot(const SimSnapshot&);
+    SimSnapshot& operator=(const SimSnapshot&);
+};
+
+//owns the queues and the lifecycle vector and runs the clock loop over them
+//nothing is shared between Simulators, so separate ones can run on separate threads,
+//and a Simulator that is kept around reuses its queue nodes and vectors on the next run
+class Simulator{
+private:
+    DList<PCB> ready_queue;
+    DList<PCB> finished_queue;
+    DList<PCB> blocked_queue;
+
+    // vector to store the process transitions.
+    StatusVector lifeCycleVector;
+
+    //the clock, cpu, scheduler and the rest of the components of the run in progress
+    SimEngine *engine;
+    SimConfig config;
+    bool keeplifecycle;
+    int sentfinished;
+    int published;   //finished processes already added to the progress averages
+    size_t sentevents;
+    size_t recorded; //transitions already turned into gantt intervals
+    int unchanged; //leading entries of the finished queue that still belong to the run snapshots come from
+
+    //where finished processes go with SimConfig::spill, and the totals kept of them as they left
+    SpillFile *spilled;
+    SimSummary spillsum;
+    std::vector<float> lateness;
+
+    void serveIO(Clock *clock);
+    void orderevents(size_t first);
+    void spillfinished();
+    void printspilled();
+
+    Simulator(const Simulator&);
+    Simulator& operator=(const Simulator&);
+public:
+    Simulator() : engine(NULL), spilled(NULL) {}
+    ~Simulator();
+
+    //simulates every process src produces until all of them have finished, results' vectors are
+    //overwritten in place so passing the same SimResults each time avoids reallocating them
+    //throws SimError if src hits an invalid record
+    void run(PCBSource *src, const SimConfig &cfg, SimResults &results);
+
+    //run split up, begin sets up a run and step advances it by one cycle, returning false once
+    //everything has finished, end writes the report files and fills in results
+    void begin(PCBSource *src, const SimConfig &cfg, SimResults &results);
+    bool step();
+    void end(SimResults &results);
+    //for a source that is filled in as the run goes on: takes processes from src again after it had run
+    //out, src must be the source the run was begun with. step returns false while the run is out of work,
+    //and picks up again once src has more
+    void refill(PCBSource *src);
+
+    //copies the state of the run in progress, the caller owns the snapshot
+    SimSnapshot* snapshot();
+    //goes back to snap, which must come from this Simulator's current run, and continues pulling
+    //processes from src, which must already be past the first snap->emitted of them
+    //finished is what end handed back for the run snap was taken from, processes that had finished
+    //by snap are refilled from it if an earlier restore went past them
+    //state transitions from before snap are dropped, none are kept from here on and end writes no files
+    void restore(const SimSnapshot *snap, PCBSource *src, const std::vector<PCB> &finished);
+    //cycles simulated so far
+    float gettime();
+
+    //same as run, over a workload that is already in memory, throws SimError before simulating
+    //anything if the workload doesn't pass the checks file input has to
+    SimResults simulate(const std::vector<PCB> &workload, const SimConfig &cfg);
+};
+
+#endif //LAB2_SIMULATOR_H
@@ -0,0 +1,38 @@
+#ifndef LAB2_SPILLFILE_H
+#define LAB2_SPILLFILE_H
+
+#include "PCB.h"
+#include "PCBSource.h"
+#include <fstream>
+#include <string>
+
+//a temporary file of processes, written one after another and then read back in the same order
+//records are the PCB as it is in memory, so the file is only good for the program that wrote it
+class SpillFile : public PCBSource{
+private:
+    std::string path;
+    std::ofstream out;
+    std::ifstream in;
+    bool reading;
+    size_t count;
+
+    SpillFile(const SpillFile&);
+    SpillFile& operator=(const SpillFile&);
+public:
+    //creates the file in dir, or in $TMPDIR (/tmp if unset) when dir is empty
+    //throws SimError if it can't be created
+    explicit SpillFile(std::string dir);
+    //removes the file
+    ~SpillFile();
+
+    //throws SimError if the write fails, e.g. on a full disk
+    void write(const PCB &pcb);
+
+    //the first call stops writing and goes back to the start of the file
+    bool next(PCB &pcb);
+
+    //processes written so far
+    size_t size();
+};
+
+#endif //LAB2_SPILLFILE_H
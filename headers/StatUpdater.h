@@ -5,13 +5,28 @@
 #include "PCB.h"
 #include "PCBStatus.h"
 #include "Clock.h"
+#include "Groups.h"
 #include <iostream>
 #include <string>
 #include <iomanip>
 #include <fstream>
+#include <map>
 #include <vector>
 
-using namespace std;
+//the totals at the bottom of the report, for callers that want the numbers rather than the file
+struct SimSummary{
+    int num_tasks, contexts;
+    float avg_burst, avg_wait, avg_turn, avg_resp;
+    float finish_time; //when the last process finished
+    //only over processes that had a deadline, lateness is finish time minus deadline
+    int deadlines, misses;
+    float late_p50, late_p90, late_p99, late_max;
+    //multi-level feedback queue only, cpu time spent at each level and processes that finished at each
+    std::vector<float> level_time;
+    std::vector<int> level_finished;
+    //group fair share only, what every group got, by group
+    std::map<int, GroupStats> groups;
+};
 
 //class that handles updating waiting times, response times, etc.
 //and prints them in a specific format to a provided file name
@@ -25,12 +40,44 @@ private:
     std::string filename;
 
     // A vector to store the status change of processes throughout the simulation.
-    std::vector<PCBStatus> *lcVector;
+    StatusVector *lcVector;
+
+    // When set, rows for finished processes are written here as soon as they complete.
+    std::ostream *stream;
+    int reported; //number of finished processes already written to the stream
+    const std::vector<float> *level_time; //the cpu's time per level, for the multi-level feedback queue
+    const std::vector<GroupStats> *group_usage; //the scheduler's time per group, for group fair share
 public:
-    StatUpdater(DList<PCB> *rq, DList<PCB> *fq, Clock *cl, int alg, std::string fn, int tq, std::vector<PCBStatus> *vec);
+    StatUpdater(DList<PCB> *rq, DList<PCB> *fq, Clock *cl, int alg, std::string fn, int tq, StatusVector *vec);
+    // enables incremental per-process results, used when the workload is streamed in
+    void setstream(std::ostream *os);
+    //adds the per-level table to the report
+    void setleveltime(const std::vector<float> *time);
+    //adds the per-group table to the report
+    void setgroupusage(const std::vector<GroupStats> *usage);
     void execute();
+    //report goes to the file named at construction, or to any stream
     void print();
+    void print(std::ostream &out);
     // A method to print the entire lifecycle of every process in the simulation.
     void printProcessLifecycle();
+    void printProcessLifecycle(std::ostream &out);
+
+    static SimSummary summarize(const std::vector<PCB> &finished);
+    //fills in the deadline part of sum from the lateness of every process that had a deadline, reorders lateness
+    static void summarizedeadlines(SimSummary &sum, std::vector<float> &lateness);
+    //counts pcb towards the level it finished at
+    static void countlevel(SimSummary &sum, const PCB &pcb);
+    //counts pcb towards its group's finished processes and latencies
+    static void countgroup(SimSummary &sum, const PCB &pcb);
+    //fills in the shares, cpu time and throttling of every group the scheduler saw
+    static void addgroupusage(SimSummary &sum, const std::vector<GroupStats> &usage);
+    static std::string algorithmname(int alg);
+
+    //pieces of the report, for writers that produce it incrementally
+    static void printtitle(std::ostream &out, int alg, int timeq, int num_tasks);
+    static void printheader(std::ostream &out);
+    static void printrow(std::ostream &out, const PCB *pcb);
+    static void printsummary(std::ostream &out, const SimSummary &sum);
 };
 #endif //LAB2_STATUPDATER_H
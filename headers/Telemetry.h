@@ -0,0 +1,60 @@
+#ifndef LAB2_TELEMETRY_H
+#define LAB2_TELEMETRY_H
+
+#include "DList.h"
+#include "PCB.h"
+#include "Clock.h"
+#include "CPU.h"
+#include "Schedulers.h"
+#include <iostream>
+#include <vector>
+
+//one row per sampling window, stored column by column so a long run costs a few bytes per window
+struct TelemetrySeries{
+    std::vector<float> time;      //when the window ended
+    std::vector<int> ready;       //ready queue length at the end of the window
+    std::vector<int> blocked;     //blocked queue length at the end of the window
+    std::vector<float> busy;      //time the cpu spent running a process during the window
+    std::vector<int> switches;    //context switches during the window
+    std::vector<int> completed;   //processes that finished during the window
+
+    void clear(){
+        time.clear(); ready.clear(); blocked.clear(); busy.clear(); switches.clear(); completed.clear();
+    }
+    size_t size() const {return time.size();}
+};
+
+//samples system state every interval ms of simulated time
+//only reads counters the cpu and dispatcher keep anyway, so the per-cycle cost is one comparison
+class Telemetry{
+private:
+    DList<PCB> *ready_queue;
+    DList<PCB> *blocked_queue;
+    CPU *cpu;
+    Dispatcher *dispatcher;
+    Clock *clock;
+    float interval, next_sample;
+
+    //counter values at the start of the current window
+    float last_time, last_busy;
+    int last_switches, last_completed;
+
+    TelemetrySeries *series; //rows are kept here, unless they are streamed
+    std::ostream *stream;    //when set, rows are written as they are sampled instead
+
+    void sample();
+    static void printrow(std::ostream &out, float start, float end, int ready, int blocked, float busy, int switches, int completed);
+public:
+    Telemetry(DList<PCB> *rq, DList<PCB> *bq, CPU *cp, Dispatcher *disp, Clock *cl, float iv, TelemetrySeries *out, std::ostream *os);
+
+    //called every clock cycle, closes the window once interval has passed
+    void execute();
+    //closes the last, possibly partial, window when the simulation ends
+    void finish();
+
+    //csv with utilization, context-switch rate and throughput worked out per window
+    static void printheader(std::ostream &out);
+    static void print(std::ostream &out, const TelemetrySeries &series);
+};
+
+#endif //LAB2_TELEMETRY_H
@@ -0,0 +1,51 @@
+#ifndef LAB2_TRACEIMPORTER_H
+#define LAB2_TRACEIMPORTER_H
+
+#include "PCB.h"
+#include "PCBSource.h"
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//turns a text dump of Linux scheduler events (perf sched script, perf script or the ftrace trace file)
+//into a workload. only sched_switch and sched_wakeup(_new) lines are used, everything else is skipped.
+//every task becomes one process: it arrives the first time it is seen, its burst is the cpu time it got,
+//its io burst is the time it spent asleep between switching out in S, D or I and being woken up, and its
+//priority is the kernel prio minus 100 (nice -20..19 become 0..39, real-time tasks 0). times are
+//in ms from the first event, tasks that never ran are dropped and pids are renumbered 1..N by arrival.
+class TraceImporter : public PCBSource{
+private:
+    //what is known about one task so far, times in ns
+    struct Task{
+        long long arrival, cpu, sleep;
+        long long run_start, sleep_start; //-1 when not running / not asleep
+        int prio;
+    };
+
+    std::string filename;
+    bool parsed;
+    long long first, last; //first and last event time
+    size_t events;
+    std::unordered_map<int, size_t> index; //kernel pid to its place in tasks
+    std::vector<Task> tasks;               //in order of arrival
+    std::vector<PCB> workload;
+    size_t position;
+
+    Task& task(int pid, long long t);
+    void parseline(char *line);
+    void parse();
+public:
+    //- reads the trace from stdin, nothing is read until the first call to next or write
+    explicit TraceImporter(std::string filename);
+
+    //throws SimError if the trace can't be opened or has no tasks that ran
+    bool next(PCB &pcb);
+
+    //writes the whole workload in the input file format
+    void write(std::ostream &out);
+
+    size_t getevents();
+};
+
+#endif //LAB2_TRACEIMPORTER_H
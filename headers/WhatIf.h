@@ -0,0 +1,37 @@
+#ifndef LAB2_WHATIF_H
+#define LAB2_WHATIF_H
+
+#include "PCB.h"
+#include "Simulator.h"
+#include <string>
+#include <vector>
+
+//re-simulates edited copies of a workload without starting over from time 0
+//the baseline run snapshots its state every interval ms, a changed workload is resumed from the latest
+//snapshot taken before the first process that differs could have arrived, and compared to the baseline
+class WhatIf{
+private:
+    const std::vector<PCB> *workload;
+    SimConfig config;
+    float interval;
+    Simulator sim;
+    SimResults baseline;
+    std::vector<SimSnapshot*> snapshots; //in the order they were taken, the first one at time 0
+
+    //index of the first process that isn't the same in both workloads
+    static size_t divergence(const std::vector<PCB> &a, const std::vector<PCB> &b);
+public:
+    WhatIf(const std::vector<PCB> *w, SimConfig cfg, float iv);
+    ~WhatIf();
+
+    //simulates the baseline workload, writing its report like a normal run if the config has an outfile
+    void run();
+
+    //simulates changed, which must also be sorted by arrival, and returns the time it was resumed from
+    float compare(const std::vector<PCB> &changed, SimResults &results);
+
+    //writes the summary of both runs and every process whose results differ from the baseline
+    void print(std::string filename, const SimResults &results, float resumed);
+};
+
+#endif //LAB2_WHATIF_H
@@ -0,0 +1,82 @@
+#include "../headers/ArrivalSorter.h"
+#include "../headers/SimError.h"
+#include <algorithm>
+
+static bool compareArrivals(const PCB &a, const PCB &b) {
+    return a.arrival < b.arrival;
+}
+
+static bool comparePids(const PCB &a, const PCB &b) {
+    return a.pid < b.pid;
+}
+
+ArrivalSorter::ArrivalSorter(PCBSource *src, size_t chunk_, std::string dir, SortOrder order_) {
+    source = src;
+    chunk = chunk_ > 0 ? chunk_ : 1;
+    tmpdir = dir;
+    order = order_;
+    started = false;
+    index = 0;
+}
+
+ArrivalSorter::~ArrivalSorter() {
+    for(size_t i = 0; i < runs.size(); ++i) delete runs[i];
+}
+
+int ArrivalSorter::key(const PCB &pcb) {
+    return order == BY_PID ? pcb.pid : pcb.arrival;
+}
+
+void ArrivalSorter::sort() {
+    std::stable_sort(buffer.begin(), buffer.end(), order == BY_PID ? comparePids : compareArrivals);
+}
+
+//sorts the buffer and writes it out as one run
+void ArrivalSorter::spill() {
+    sort();
+    Run *run = new Run(tmpdir);
+    runs.push_back(run);
+    for(size_t i = 0; i < buffer.size(); ++i) run->file.write(buffer[i]);
+    buffer.clear();
+}
+
+//reads the whole source, either into one sorted buffer or into runs on disk ready to be merged
+void ArrivalSorter::prepare() {
+    started = true;
+    buffer.reserve(std::min(chunk, size_t(1) << 20));
+    PCB pcb;
+    while(source->next(pcb)){
+        if(buffer.size() == chunk) spill();
+        buffer.push_back(pcb);
+    }
+    if(runs.empty()){
+        sort();
+        return;
+    }
+    if(!buffer.empty()) spill();
+    std::vector<PCB>().swap(buffer);
+
+    for(size_t i = 0; i < runs.size(); ++i){
+        if(runs[i]->file.next(runs[i]->head)) fronts.push(std::make_pair(key(runs[i]->head), i));
+    }
+}
+
+bool ArrivalSorter::next(PCB &pcb) {
+    if(!started) prepare();
+    if(runs.empty()){
+        if(index >= buffer.size()) return false;
+        pcb = buffer[index++];
+        return true;
+    }
+
+    if(fronts.empty()) return false;
+    size_t r = fronts.top().second;
+    fronts.pop();
+    pcb = runs[r]->head;
+    if(runs[r]->file.next(runs[r]->head)) fronts.push(std::make_pair(key(runs[r]->head), r));
+    return true;
+}
+
+size_t ArrivalSorter::getruns() {
+    return runs.size();
+}
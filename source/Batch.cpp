@@ -0,0 +1,155 @@
+#include "../headers/Batch.h"
+#include "../headers/PCBReader.h"
+#include "../headers/SimError.h"
+#include <algorithm>
+#include <cerrno>
+#include <dirent.h>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <thread>
+
+Batch::Batch(std::string list, std::string dir, SimConfig cfg) {
+    config = cfg;
+    // the rows of a streamed run would interleave between files.
+    config.stream = NULL;
+    outdir = dir;
+
+    std::vector<std::string> inputs;
+    struct stat info;
+    if(stat(list.c_str(), &info) != 0) throw SimError("Can't open " + list + ".");
+    bool listed = !S_ISDIR(info.st_mode);
+    if(!listed){
+        DIR *entries = opendir(list.c_str());
+        if(entries == NULL) throw SimError("Can't open " + list + ".");
+        for(struct dirent *entry = readdir(entries); entry != NULL; entry = readdir(entries)){
+            // hidden files are left alone, editors and version control keep their own there.
+            if(entry->d_name[0] == '.') continue;
+            inputs.push_back(list + "/" + entry->d_name);
+        }
+        closedir(entries);
+    }
+    else {
+        // a manifest's paths are taken as they are, relative ones from the working directory.
+        std::ifstream manifest(list);
+        std::string line;
+        while(std::getline(manifest, line)){
+            if(!line.empty()) inputs.push_back(line);
+        }
+    }
+
+    std::set<std::string> names;
+    for(size_t i = 0; i < inputs.size(); ++i){
+        // only a directory's regular files are inputs, anything a manifest names has to be one and fails if it isn't.
+        bool regular = stat(inputs[i].c_str(), &info) == 0 && S_ISREG(info.st_mode);
+        if(!regular && !listed) continue;
+        Job job;
+        job.input = inputs[i];
+        job.name = inputs[i].substr(inputs[i].find_last_of('/') + 1);
+        job.size = regular ? info.st_size : 0;
+        if(job.name == "summary") throw SimError("An input can't be named summary, the batch summary goes there.");
+        if(!names.insert(job.name).second) throw SimError("Two inputs are named " + job.name + ", their reports would overwrite each other.");
+        jobs.push_back(job);
+    }
+    std::stable_sort(jobs.begin(), jobs.end(), [](const Job &a, const Job &b){return a.size > b.size;});
+    // a directory already there is reused, the reports in it are overwritten.
+    if(mkdir(outdir.c_str(), 0755) != 0 && (errno != EEXIST || stat(outdir.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))){
+        throw SimError("Can't make the output directory " + outdir + ".");
+    }
+}
+
+//each worker takes the largest input nobody has started yet until there are none left
+void Batch::worker(std::atomic<size_t> *next) {
+    Simulator sim;
+    SimResults results;
+    for(size_t j = (*next)++; j < jobs.size(); j = (*next)++){
+        SimConfig cfg = config;
+        cfg.outfile = outdir + "/" + jobs[j].name;
+        try {
+            struct stat info;
+            if(stat(jobs[j].input.c_str(), &info) != 0 || !S_ISREG(info.st_mode) || !std::ifstream(jobs[j].input)){
+                throw SimError("Can't open " + jobs[j].input + ".");
+            }
+            PCBReader reader(jobs[j].input);
+            sim.run(&reader, cfg, results);
+            jobs[j].summary = results.summary;
+        }catch(SimError &e){
+            jobs[j].error = e.what();
+        }
+    }
+}
+
+void Batch::run() {
+    int threads = std::thread::hardware_concurrency();
+    if(threads < 1) threads = 1;
+    if(size_t(threads) > jobs.size()) threads = jobs.size();
+
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> pool;
+    for(int t = 0; t < threads; ++t) pool.push_back(std::thread(&Batch::worker, this, &next));
+    for(size_t t = 0; t < pool.size(); ++t) pool[t].join();
+}
+
+int Batch::print(std::string filename) {
+    int colwidth = 11;
+    std::ofstream outfile(filename);
+    if(!outfile) throw SimError("Can't write " + filename + ".");
+
+    // rows in the order of the names, not of the sizes they were run in.
+    std::vector<const Job*> rows;
+    for(size_t j = 0; j < jobs.size(); ++j) rows.push_back(&jobs[j]);
+    std::sort(rows.begin(), rows.end(), [](const Job *a, const Job *b){return a->name < b->name;});
+
+    outfile << "*******************************************************************" << std::endl;
+    outfile << "Scheduling Algorithm: " << StatUpdater::algorithmname(config.algorithm) << std::endl;
+    outfile << "(Batch Inputs = " << jobs.size() << " Quantum = " << config.timeq << ")" << std::endl;
+    outfile << "*******************************************************************" << std::endl;
+    outfile << "---------------------------------------------------------------------------------------------------------" << std::endl;
+    outfile << "| " << std::left << std::setw(25) << "Input" << "| " << std::left << std::setw(colwidth) << "Processes"
+            << "| " << std::left << std::setw(colwidth) << "Waiting" << "| " << std::left << std::setw(colwidth) << "Turnaround"
+            << "| " << std::left << std::setw(colwidth) << "Response" << "| " << std::left << std::setw(colwidth) << "C. Switches"
+            << "| " << std::left << std::setw(colwidth) << "Finish" << "| " << std::endl;
+    outfile << "---------------------------------------------------------------------------------------------------------" << std::endl;
+
+    // the totals weigh every process the same, whichever input it came from.
+    SimSummary total = SimSummary();
+    double wait = 0, turn = 0, resp = 0;
+    int failed = 0;
+    for(size_t r = 0; r < rows.size(); ++r){
+        const Job &job = *rows[r];
+        outfile << "| " << std::left << std::setw(25) << job.name;
+        if(!job.error.empty()){
+            failed++;
+            outfile << "| " << job.error << std::endl;
+        }
+        else {
+            const SimSummary &s = job.summary;
+            outfile << "| " << std::left << std::setw(colwidth) << s.num_tasks << "| " << std::left << std::setw(colwidth) << s.avg_wait
+                    << "| " << std::left << std::setw(colwidth) << s.avg_turn << "| " << std::left << std::setw(colwidth) << s.avg_resp
+                    << "| " << std::left << std::setw(colwidth) << s.contexts << "| " << std::left << std::setw(colwidth) << s.finish_time
+                    << "| " << std::endl;
+            total.num_tasks += s.num_tasks;
+            total.contexts += s.contexts;
+            wait += double(s.avg_wait) * s.num_tasks;
+            turn += double(s.avg_turn) * s.num_tasks;
+            resp += double(s.avg_resp) * s.num_tasks;
+            total.finish_time = std::max(total.finish_time, s.finish_time);
+        }
+        outfile << "---------------------------------------------------------------------------------------------------------" << std::endl;
+    }
+
+    if(total.num_tasks > 0){
+        total.avg_wait = wait / total.num_tasks;
+        total.avg_turn = turn / total.num_tasks;
+        total.avg_resp = resp / total.num_tasks;
+    }
+    outfile << std::endl;
+    outfile << "Inputs Simulated: " << jobs.size() - failed << " of " << jobs.size() << "\t\tTotal Processes: " << total.num_tasks << std::endl;
+    outfile << "Average Waiting Time: " << total.avg_wait << " ms\t\tAverage Turnaround Time: " << total.avg_turn << " ms" << std::endl;
+    outfile << "Average Response Time: " << total.avg_resp << " ms\t\tLongest Finish Time: " << total.finish_time << " ms" << std::endl;
+    outfile << "Total No. of Context Switching Performed: " << total.contexts << std::endl;
+    if(!outfile) throw SimError("Can't write " + filename + ".");
+    return failed;
+}
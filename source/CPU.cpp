@@ -1,14 +1,42 @@
 #include "../headers/CPU.h"
 #include "../headers/PCBStatus.h"
+#include "../headers/Phases.h"
 #include <vector>
 
 
-CPU::CPU(DList<PCB> *fq, Clock *cl, std::vector<PCBStatus> *vec) {
+CPU::CPU(DList<PCB> *fq, DList<PCB> *bq, Clock *cl, StatusVector *vec) {
     pcb = NULL;
     idle = true;
     finished_queue = fq;
+    blocked_queue = bq;
     clock = cl;
     lcVector = vec;
+    busy_time = 0;
+    completed = 0;
+}
+
+CPU::CPU(const CPU &other) {
+    pcb = NULL;
+    *this = other;
+}
+
+CPU& CPU::operator=(const CPU &other) {
+    if(this == &other) return *this;
+    delete pcb;
+    pcb = other.pcb != NULL ? new PCB(*other.pcb) : NULL;
+    idle = other.idle;
+    clock = other.clock;
+    finished_queue = other.finished_queue;
+    blocked_queue = other.blocked_queue;
+    lcVector = other.lcVector;
+    busy_time = other.busy_time;
+    completed = other.completed;
+    level_time = other.level_time;
+    return *this;
+}
+
+CPU::~CPU() {
+    delete pcb;
 }
 
 //used by others to determine what the cpu is working on like priority and time left
@@ -21,6 +49,19 @@ bool CPU::isidle() {
     return idle;
 }
 
+//running totals, used for sampling utilization and throughput over time
+float CPU::getbusytime() {
+    return busy_time;
+}
+
+int CPU::getcompleted() {
+    return completed;
+}
+
+const std::vector<float>& CPU::getleveltime() {
+    return level_time;
+}
+
 //called every clock cycle
 void CPU::execute() {
     if(pcb != NULL){
@@ -30,9 +71,14 @@ void CPU::execute() {
             pcb->resp_time = clock->gettime() - pcb->arrival;
         }
         pcb->time_left -= .5; //simulate process being worked on for a clock cycle
+        busy_time += .5;
+        if(pcb->level >= int(level_time.size())) level_time.resize(pcb->level + 1, 0);
+        level_time[pcb->level] += .5;
         if(pcb->time_left <= 0) { //terminate it if its done and set self to idle
+            // a process with phases left goes off to its next i/o burst instead.
+            if(Phases::advance(*pcb)) block();
             // terminate the process if it does not have any more time left.
-            terminate();
+            else terminate();
             // set the CPU to idle.
             idle = true;
         }
@@ -44,6 +90,7 @@ void CPU::terminate() {
     // Simulate a 0.5 overhead to move the process from running -> finished.
     pcb->finish_time = clock->gettime()+.5;
     finished_queue->add_end(*pcb);
+    completed++;
     
     // Capture the state transition.
     PCBStatus status(PROCESS_STATE::COMPLETED, pcb->finish_time, pcb->pid);
@@ -51,4 +98,17 @@ void CPU::terminate() {
 
     delete pcb;
     pcb = NULL;
-}
\ No newline at end of file
+}
+
+//routine to send a process that finished one of its cpu bursts to its next i/o burst
+void CPU::block() {
+    // Same 0.5 overhead as terminating, the process leaves the cpu on its own.
+    PCBStatus status(PROCESS_STATE::IN_BLOCKED_QUEUE, clock->gettime()+.5, pcb->pid);
+    lcVector->push_back(status);
+    // giving up the cpu for i/o counts the same as it does for the multi-level feedback queue's scheduler.
+    if(pcb->level > 0) pcb->level--;
+    blocked_queue->add_end(*pcb);
+
+    delete pcb;
+    pcb = NULL;
+}
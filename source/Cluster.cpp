@@ -0,0 +1,219 @@
+#include "../headers/Cluster.h"
+#include "../headers/SimError.h"
+#include "../headers/StatUpdater.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <queue>
+
+bool Cluster::Feed::next(PCB &pcb) {
+    if(waiting.empty()) return false;
+    pcb = waiting.front();
+    waiting.pop_front();
+    return true;
+}
+
+Cluster::Cluster(int count, const SimConfig &cfg, Placement how, float windowms) : rng(cfg.seed) {
+    if(count < 1 || windowms <= 0) throw SimError("A cluster needs at least one machine and a window greater than 0.");
+    config = cfg;
+    // every machine would write the same report files, only the cluster's summary is written.
+    config.outfile = "";
+    config.stream = NULL;
+    placement = how;
+    window = windowms;
+    rotation = 0;
+    for(int m = 0; m < count; ++m) machines.push_back(new Machine());
+
+    generation = 0;
+    waiting = 0;
+    stopping = false;
+    until = 0;
+    int threads = std::thread::hardware_concurrency();
+    if(threads < 1) threads = 1;
+    if(threads > count) threads = count;
+    for(int t = 0; t < threads; ++t) workers.push_back(std::thread(&Cluster::worker, this));
+}
+
+Cluster::~Cluster() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+        generation++;
+    }
+    wake.notify_all();
+    for(size_t t = 0; t < workers.size(); ++t) workers[t].join();
+    for(size_t m = 0; m < machines.size(); ++m) delete machines[m];
+}
+
+//processes placed on the machine that haven't finished yet, waiting, blocked or running
+int Cluster::load(size_t m) {
+    return machines[m]->placed - machines[m]->finished.count;
+}
+
+size_t Cluster::choose() {
+    // there is nothing to choose between, and the least loaded heap is only built for that policy.
+    if(machines.size() == 1) return 0;
+    if(placement == PLACE_ROUND_ROBIN) return rotation++ % machines.size();
+    if(placement == PLACE_TWO_CHOICES){
+        size_t a = rng() % machines.size();
+        size_t b = rng() % (machines.size() - 1);
+        if(b >= a) b++;
+        return load(b) < load(a) ? b : a;
+    }
+    // least loaded, ties go to the lowest numbered machine. loads only go up while a window is being
+    // placed, so the heap built at its start stays right as long as the chosen machine goes back in.
+    size_t best = lightest.top().second;
+    lightest.pop();
+    lightest.push(std::make_pair(load(best) + 1, best));
+    return best;
+}
+
+void Cluster::worker() {
+    unsigned long long seen = 0;
+    while(true){
+        float end;
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            wake.wait(guard, [&]{return generation != seen;});
+            seen = generation;
+            if(stopping) return;
+            end = until;
+        }
+        // a machine that has run out of work stops short of end, it catches up once it is sent more.
+        for(size_t a = nextmachine++; a < active.size(); a = nextmachine++){
+            Machine &machine = *machines[active[a]];
+            bool more = true;
+            while(more && machine.sim.gettime() < end) more = machine.sim.step();
+            machine.active = more;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        if(++waiting == int(workers.size())) done.notify_one();
+    }
+}
+
+void Cluster::advance(float end) {
+    std::unique_lock<std::mutex> guard(lock);
+    until = end;
+    nextmachine = 0;
+    waiting = 0;
+    generation++;
+    wake.notify_all();
+    done.wait(guard, [&]{return waiting == int(workers.size());});
+
+    size_t kept = 0;
+    for(size_t a = 0; a < active.size(); ++a){
+        if(machines[active[a]]->active) active[kept++] = active[a];
+    }
+    active.resize(kept);
+}
+
+void Cluster::run(PCBSource *src) {
+    for(size_t m = 0; m < machines.size(); ++m){
+        SimConfig cfg = config;
+        // independent random streams per machine, a cluster of one runs exactly like a single machine.
+        cfg.replica = config.replica + m;
+        machines[m]->finished.next = config.sink;
+        cfg.sink = &machines[m]->finished;
+        machines[m]->placed = 0;
+        machines[m]->active = false;
+        machines[m]->finished.count = 0;
+        machines[m]->sim.begin(&machines[m]->feed, cfg, machines[m]->results);
+    }
+
+    active.clear();
+    PCB pcb;
+    bool more = src->next(pcb);
+    float now = 0;
+    while(more){
+        // everything arriving before the end of the window is placed before any machine gets there.
+        if(placement == PLACE_LEAST_LOADED){
+            std::vector<std::pair<int, size_t> > loads;
+            for(size_t m = 0; m < machines.size(); ++m) loads.push_back(std::make_pair(load(m), m));
+            lightest = LoadHeap(std::greater<std::pair<int, size_t> >(), loads);
+        }
+        while(more && pcb.arrival < now + window){
+            size_t m = choose();
+            machines[m]->feed.waiting.push_back(pcb);
+            machines[m]->placed++;
+            machines[m]->sim.refill(&machines[m]->feed);
+            if(!machines[m]->active){
+                machines[m]->active = true;
+                active.push_back(m);
+            }
+            more = src->next(pcb);
+        }
+        // nothing arrives until the next process does, so the machines can run that far without checking back.
+        float end = more ? pcb.arrival : std::numeric_limits<float>::infinity();
+        advance(end);
+        now = end;
+    }
+    advance(std::numeric_limits<float>::infinity());
+    for(size_t m = 0; m < machines.size(); ++m) machines[m]->sim.end(machines[m]->results);
+}
+
+const SimResults& Cluster::results(size_t machine) {
+    return machines[machine]->results;
+}
+
+size_t Cluster::size() {
+    return machines.size();
+}
+
+void Cluster::print(std::string filename) {
+    const char *names[3] = {"Round Robin", "Least Loaded", "Power Of Two Choices"};
+    int colwidth = 11;
+    std::ofstream outfile(filename);
+
+    outfile << "*******************************************************************" << std::endl;
+    outfile << "Scheduling Algorithm: " << StatUpdater::algorithmname(config.algorithm) << std::endl;
+    outfile << "(Machines = " << machines.size() << " Placement = " << names[placement] << " Window = " << window
+            << " Quantum = " << config.timeq << ")" << std::endl;
+    outfile << "*******************************************************************" << std::endl;
+    outfile << "---------------------------------------------------------------------------------------------" << std::endl;
+    outfile << "| " << std::left << std::setw(colwidth) << "Machine" << "| " << std::left << std::setw(colwidth) << "Processes"
+            << "| " << std::left << std::setw(colwidth) << "Waiting" << "| " << std::left << std::setw(colwidth) << "Turnaround"
+            << "| " << std::left << std::setw(colwidth) << "Response" << "| " << std::left << std::setw(colwidth) << "C. Switches"
+            << "| " << std::left << std::setw(colwidth) << "Finish" << "| " << std::endl;
+    outfile << "---------------------------------------------------------------------------------------------" << std::endl;
+
+    // the totals weigh every process the same, whichever machine it ran on.
+    SimSummary total = SimSummary();
+    double wait = 0, turn = 0, resp = 0;
+    int busiest = 0;
+    for(size_t m = 0; m < machines.size(); ++m){
+        const SimSummary &s = machines[m]->results.summary;
+        outfile << "| " << std::left << std::setw(colwidth) << m << "| " << std::left << std::setw(colwidth) << s.num_tasks
+                << "| " << std::left << std::setw(colwidth) << s.avg_wait << "| " << std::left << std::setw(colwidth) << s.avg_turn
+                << "| " << std::left << std::setw(colwidth) << s.avg_resp << "| " << std::left << std::setw(colwidth) << s.contexts
+                << "| " << std::left << std::setw(colwidth) << s.finish_time << "| " << std::endl;
+        outfile << "---------------------------------------------------------------------------------------------" << std::endl;
+        total.num_tasks += s.num_tasks;
+        total.contexts += s.contexts;
+        wait += double(s.avg_wait) * s.num_tasks;
+        turn += double(s.avg_turn) * s.num_tasks;
+        resp += double(s.avg_resp) * s.num_tasks;
+        total.finish_time = std::max(total.finish_time, s.finish_time);
+        busiest = std::max(busiest, s.num_tasks);
+    }
+    if(total.num_tasks > 0){
+        total.avg_wait = wait / total.num_tasks;
+        total.avg_turn = turn / total.num_tasks;
+        total.avg_resp = resp / total.num_tasks;
+    }
+
+    outfile << std::endl;
+    outfile << "Total Processes: " << total.num_tasks << "\t\tMost On One Machine: " << busiest << " (Mean "
+            << double(total.num_tasks) / machines.size() << ")" << std::endl;
+    outfile << "Average Waiting Time: " << total.avg_wait << " ms\t\tAverage Turnaround Time: " << total.avg_turn << " ms" << std::endl;
+    outfile << "Average Response Time: " << total.avg_resp << " ms\t\tLongest Finish Time: " << total.finish_time << " ms" << std::endl;
+    outfile << "Total No. of Context Switching Performed: " << total.contexts << std::endl;
+}
+
+int Cluster::parseplacement(std::string name) {
+    if(name == "rr") return PLACE_ROUND_ROBIN;
+    if(name == "least") return PLACE_LEAST_LOADED;
+    if(name == "p2c") return PLACE_TWO_CHOICES;
+    return -1;
+}
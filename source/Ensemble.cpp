@@ -0,0 +1,92 @@
+#include "../headers/Ensemble.h"
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+Ensemble::Ensemble(const std::vector<PCB> *w, SimConfig cfg, int k) {
+    workload = w;
+    config = cfg;
+    runs = k;
+    // the runs don't write report files of their own, only the ensemble summary is printed.
+    config.outfile = "";
+    config.stream = NULL;
+}
+
+//each worker keeps one Simulator and pulls replicas off the shared counter until they run out
+void Ensemble::worker(std::atomic<int> *next) {
+    Simulator sim;
+    SimResults res;
+    for(int k = (*next)++; k < runs; k = (*next)++){
+        SimConfig cfg = config;
+        cfg.replica = k;
+        WorkloadSource src(workload);
+        sim.run(&src, cfg, res);
+        results[k] = res.summary;
+    }
+}
+
+void Ensemble::run() {
+    results.assign(runs, SimSummary());
+    int threads = std::thread::hardware_concurrency();
+    if(threads < 1) threads = 1;
+    if(threads > runs) threads = runs;
+
+    std::atomic<int> next(0);
+    std::vector<std::thread> pool;
+    for(int t = 0; t < threads; ++t) pool.push_back(std::thread(&Ensemble::worker, this, &next));
+    for(size_t t = 0; t < pool.size(); ++t) pool[t].join();
+}
+
+//two sided 95% critical values of Student's t for 1..30 degrees of freedom, normal beyond that
+static double tcritical(int df) {
+    static const double table[30] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                                     2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                                     2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if(df < 1) return 0;
+    if(df <= 30) return table[df-1];
+    return 1.96;
+}
+
+void Ensemble::print(std::string filename) {
+    const char *names[6] = {"Average CPU Burst Time", "Average Waiting Time", "Average Turnaround Time",
+                            "Average Response Time", "Context Switches", "Finish Time"};
+    int colwidth = 11;
+    std::ofstream outfile(filename);
+
+    outfile << "*******************************************************************" << std::endl;
+    outfile << "Scheduling Algorithm: " << StatUpdater::algorithmname(config.algorithm) << std::endl;
+    outfile << "(Ensemble Runs = " << runs << " Quantum = " << config.timeq << " Seed = " << config.seed << ")" << std::endl;
+    outfile << "*******************************************************************" << std::endl;
+    outfile << "--------------------------------------------------------------------------------------------" << std::endl;
+    outfile << "| " << std::left << std::setw(25) << "Metric" << "| " << std::left << std::setw(colwidth) << "Mean"
+            << "| " << std::left << std::setw(colwidth) << "Std. Dev" << "| " << std::left << std::setw(colwidth) << "95% CI Low"
+            << "| " << std::left << std::setw(colwidth) << "95% CI High" << "| " << std::endl;
+    outfile << "--------------------------------------------------------------------------------------------" << std::endl;
+
+    for(int m = 0; m < 6; ++m){
+        double sum = 0, sumsq = 0;
+        for(int k = 0; k < runs; ++k){
+            double v = 0;
+            switch(m){
+                case 0: v = results[k].avg_burst; break;
+                case 1: v = results[k].avg_wait; break;
+                case 2: v = results[k].avg_turn; break;
+                case 3: v = results[k].avg_resp; break;
+                case 4: v = results[k].contexts; break;
+                case 5: v = results[k].finish_time; break;
+            }
+            sum += v;
+            sumsq += v * v;
+        }
+        double mean = sum / runs;
+        double var = runs > 1 ? (sumsq - runs * mean * mean) / (runs - 1) : 0;
+        double sd = var > 0 ? std::sqrt(var) : 0;
+        double half = tcritical(runs - 1) * sd / std::sqrt(double(runs));
+
+        outfile << "| " << std::left << std::setw(25) << names[m] << "| " << std::left << std::setw(colwidth) << mean
+                << "| " << std::left << std::setw(colwidth) << sd << "| " << std::left << std::setw(colwidth) << mean - half
+                << "| " << std::left << std::setw(colwidth) << mean + half << "| " << std::endl;
+        outfile << "--------------------------------------------------------------------------------------------" << std::endl;
+    }
+}
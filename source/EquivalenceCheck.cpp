@@ -0,0 +1,314 @@
+#include "../headers/EquivalenceCheck.h"
+#include "../headers/ArrivalSorter.h"
+#include "../headers/Cluster.h"
+#include "../headers/PCBReader.h"
+#include "../headers/PCBSource.h"
+#include "../headers/SimError.h"
+#include "../headers/StatUpdater.h"
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+static std::string joinlines(const std::vector<std::string> &lines) {
+    std::string text;
+    for(size_t i = 0; i < lines.size(); ++i) text += lines[i] + "\n";
+    return text;
+}
+
+//the workload's listed phases are in the table returned, it has to be kept for as long as the workload is
+static std::shared_ptr<PhaseTable> parse(const std::vector<std::string> &lines, std::vector<PCB> &workload) {
+    std::stringstream text(joinlines(lines));
+    PCBReader reader(text);
+    reader.readall(workload);
+    return reader.phases();
+}
+
+//input read out of order through the external sort, a few processes per run so the runs get merged
+static void sortedruns(const std::vector<std::string> &lines, const std::vector<PCB> &workload, const SimConfig &cfg, EngineOutput &out) {
+    std::stringstream text(joinlines(lines));
+    PCBReader reader(text);
+    reader.allowunsorted();
+    ArrivalSorter sorter(&reader, 3, "");
+    RecordingSink sink;
+    SimConfig config = cfg;
+    config.sink = &sink;
+    Simulator sim;
+    SimResults results;
+    sim.run(&sorter, config, results);
+    out = sink.output;
+}
+
+//finished processes leave for a spill file every cycle
+static void spilled(const std::vector<std::string> &lines, const std::vector<PCB> &workload, const SimConfig &cfg, EngineOutput &out) {
+    RecordingSink sink;
+    SimConfig config = cfg;
+    config.sink = &sink;
+    config.spill = 2;
+    Simulator sim;
+    SimResults results;
+    WorkloadSource src(&workload);
+    sim.run(&src, config, results);
+    out = sink.output;
+}
+
+//runs to the end once, then goes back to a snapshot from about halfway through the arrivals and runs again
+//what was recorded up to the snapshot followed by the second run has to be the whole run
+static void resumed(const std::vector<std::string> &lines, const std::vector<PCB> &workload, const SimConfig &cfg, EngineOutput &out) {
+    RecordingSink sink;
+    SimConfig config = cfg;
+    config.sink = &sink;
+    Simulator sim;
+    SimResults results;
+    WorkloadSource src(&workload);
+    sim.begin(&src, config, results);
+    float halfway = workload.empty() ? 0 : workload[workload.size() / 2].arrival;
+    bool more = true;
+    while(more && sim.gettime() < halfway) more = sim.step();
+    SimSnapshot *snap = sim.snapshot();
+    size_t events = sink.output.events.size(), finished = sink.output.finished.size();
+    while(sim.step());
+    sim.end(results);
+
+    sink.output.events.resize(events);
+    sink.output.finished.resize(finished);
+    WorkloadSource rest(&workload, snap->emitted);
+    sim.restore(snap, &rest, results.finished);
+    while(sim.step());
+    sim.end(results);
+    delete snap;
+    out = sink.output;
+}
+
+//one machine behind the cluster's placement, fed a window at a time instead of reading its source itself
+static void cluster(const SimConfig &cfg, const std::vector<PCB> &workload, Placement how, EngineOutput &out) {
+    RecordingSink sink;
+    SimConfig config = cfg;
+    config.sink = &sink;
+    // a window shorter than most gaps between arrivals, so the machine is stopped and refilled often.
+    Cluster machines(1, config, how, 1.5);
+    WorkloadSource src(&workload);
+    machines.run(&src);
+    out = sink.output;
+}
+
+//every placement policy has to send everything to the one machine there is
+static void clusterleast(const std::vector<std::string> &lines, const std::vector<PCB> &workload, const SimConfig &cfg, EngineOutput &out) {
+    cluster(cfg, workload, PLACE_LEAST_LOADED, out);
+}
+
+static void clusterrr(const std::vector<std::string> &lines, const std::vector<PCB> &workload, const SimConfig &cfg, EngineOutput &out) {
+    cluster(cfg, workload, PLACE_ROUND_ROBIN, out);
+}
+
+static void clusterp2c(const std::vector<std::string> &lines, const std::vector<PCB> &workload, const SimConfig &cfg, EngineOutput &out) {
+    cluster(cfg, workload, PLACE_TWO_CHOICES, out);
+}
+
+EquivalenceCheck::EquivalenceCheck(unsigned seed) : rng(seed) {
+    addengine("sorted runs", sortedruns);
+    addengine("spill", spilled);
+    addengine("snapshot restore", resumed);
+    addengine("cluster of one, least loaded", clusterleast);
+    addengine("cluster of one, round robin", clusterrr);
+    addengine("cluster of one, power of two choices", clusterp2c);
+}
+
+void EquivalenceCheck::addengine(std::string name, SimEngineRun run) {
+    Engine engine = {name, run};
+    engines.push_back(engine);
+}
+
+std::vector<std::string> EquivalenceCheck::randomworkload() {
+    std::vector<std::string> lines;
+    int count = 1 + rng() % 30;
+    int arrival = rng() % 5;
+    for(int pid = 1; pid <= count; ++pid){
+        // ties in arrival time are where engines most easily disagree, so a third of processes share one.
+        if(rng() % 3 != 0) arrival += 1 + rng() % 4;
+        std::stringstream line;
+        line << pid << " " << arrival << " ";
+        int kind = rng() % 10;
+        int io = 0;
+        if(kind < 7){
+            line << 1 + rng() % 15;
+            if(rng() % 2) io = 1 + rng() % 8;
+        }
+        else if(kind < 9){
+            int bursts = 3 + 2 * (rng() % 3);
+            for(int burst = 0; burst < bursts; ++burst) line << (burst > 0 ? "," : "") << 1 + rng() % 8;
+        }
+        else line << "g" << 1 + rng() % 6 << ":" << 1 + rng() % 5 << ":" << 1 + rng() % 6;
+        line << " " << rng() % 6 << " " << io;
+        // a group needs the deadline column in front of it, 0 there means no deadline.
+        int deadline = rng() % 2 ? 1 + rng() % 60 : 0;
+        int group = rng() % 4;
+        if(group > 0) line << " " << deadline << " " << group;
+        else if(deadline > 0) line << " " << deadline;
+        lines.push_back(line.str());
+    }
+    return lines;
+}
+
+SimConfig EquivalenceCheck::randomconfig() {
+    SimConfig cfg;
+    cfg.algorithm = rng() % 8;
+    if(cfg.algorithm == 2 || cfg.algorithm == 3 || cfg.algorithm == 4 || cfg.algorithm == 6 || cfg.algorithm == 7) cfg.timeq = 1 + rng() % 8;
+    cfg.seed = rng();
+    if(cfg.algorithm == 6){
+        const float boosts[3] = {0, 40, 1000};
+        cfg.boost = boosts[rng() % 3];
+    }
+    if(cfg.algorithm == 7){
+        // uneven shares, and quotas short enough next to their periods that groups get throttled often.
+        for(int group = 0; group < 4; ++group){
+            if(rng() % 3 == 0) continue;
+            GroupShare share;
+            share.shares = 1 + rng() % 4;
+            if(rng() % 2){
+                share.period = 2 + rng() % 10;
+                share.quota = 0.5f * (1 + rng() % int(2 * share.period - 1));
+            }
+            cfg.groups[group] = share;
+        }
+    }
+    return cfg;
+}
+
+static std::string describe(PCBStatus status) {
+    std::stringstream text;
+    text << "P" << status.getPid() << " " << status.e2s(status.getRecordedState()) << " at " << status.getRecordedCpuTime();
+    return text.str();
+}
+
+std::string EquivalenceCheck::difference(const Engine &engine, const std::vector<std::string> &lines, const SimConfig &cfg) {
+    std::vector<PCB> workload;
+    std::shared_ptr<PhaseTable> phases;
+    Simulator sim;
+    SimResults reference;
+    SimConfig config = cfg;
+    config.lifecycle = true;
+    try {
+        phases = parse(lines, workload);
+        WorkloadSource src(&workload);
+        sim.run(&src, config, reference);
+    }catch(SimError &e){
+        // shrinking can make the workload invalid, there is nothing to compare then.
+        return "";
+    }
+
+    EngineOutput candidate;
+    try {
+        engine.run(lines, workload, config, candidate);
+    }catch(SimError &e){
+        return std::string("the engine failed: ") + e.what();
+    }
+
+    std::stringstream text;
+    // the first event that differs is the first thing that went wrong, the processes' numbers only follow from it.
+    for(size_t index = 0; index < reference.lifecycle.size() || index < candidate.events.size(); ++index){
+        if(index >= candidate.events.size()){
+            text << "event " << index << ": expected " << describe(reference.lifecycle[index]) << ", the engine stopped";
+            return text.str();
+        }
+        if(index >= reference.lifecycle.size()){
+            text << "event " << index << ": the reference stopped, the engine had " << describe(candidate.events[index]);
+            return text.str();
+        }
+        PCBStatus a = reference.lifecycle[index], b = candidate.events[index];
+        if(a.getPid() != b.getPid() || a.getRecordedState() != b.getRecordedState() || a.getRecordedCpuTime() != b.getRecordedCpuTime()){
+            text << "event " << index << ": expected " << describe(a) << ", the engine had " << describe(b);
+            return text.str();
+        }
+    }
+    if(reference.finished.size() != candidate.finished.size()){
+        text << reference.finished.size() << " processes finished, the engine finished " << candidate.finished.size();
+        return text.str();
+    }
+    for(size_t index = 0; index < reference.finished.size(); ++index){
+        const PCB &a = reference.finished[index], &b = candidate.finished[index];
+        if(a.pid != b.pid || a.burst != b.burst || a.finish_time != b.finish_time || a.wait_time != b.wait_time
+           || a.resp_time != b.resp_time || a.num_context != b.num_context){
+            text << "process " << index << " to finish: expected P" << a.pid << " finish " << a.finish_time << " waiting " << a.wait_time
+                 << " response " << a.resp_time << " switches " << a.num_context << ", the engine had P" << b.pid << " finish "
+                 << b.finish_time << " waiting " << b.wait_time << " response " << b.resp_time << " switches " << b.num_context;
+            return text.str();
+        }
+    }
+    return "";
+}
+
+//the same line with one column replaced, or removed when value is empty
+static std::string withcolumn(const std::string &line, size_t column, const std::string &value) {
+    std::stringstream in(line);
+    std::vector<std::string> columns;
+    std::string token;
+    while(in >> token) columns.push_back(token);
+    if(column >= columns.size()) return line;
+    if(value.empty()) columns.erase(columns.begin() + column);
+    else columns[column] = value;
+    std::string out;
+    for(size_t i = 0; i < columns.size(); ++i) out += (i > 0 ? " " : "") + columns[i];
+    return out;
+}
+
+std::vector<std::string> EquivalenceCheck::shrink(const Engine &engine, std::vector<std::string> lines, const SimConfig &cfg) {
+    bool smaller = true;
+    while(smaller){
+        smaller = false;
+        // drop whole processes first, from the back so the indexes still to try don't move.
+        for(size_t i = lines.size(); i-- > 0;){
+            std::vector<std::string> fewer = lines;
+            fewer.erase(fewer.begin() + i);
+            if(difference(engine, fewer, cfg).empty()) continue;
+            lines = fewer;
+            smaller = true;
+        }
+        // then make the ones left as plain as possible: a single burst of 1, no priority, i/o, deadline or group.
+        const size_t columns[5] = {6, 5, 4, 3, 2};
+        const char *values[5] = {"", "", "0", "0", "1"};
+        for(size_t i = 0; i < lines.size(); ++i){
+            for(int s = 0; s < 5; ++s){
+                std::string simpler = withcolumn(lines[i], columns[s], values[s]);
+                if(simpler == lines[i]) continue;
+                std::vector<std::string> plainer = lines;
+                plainer[i] = simpler;
+                if(difference(engine, plainer, cfg).empty()) continue;
+                lines = plainer;
+                smaller = true;
+            }
+        }
+    }
+    return lines;
+}
+
+bool EquivalenceCheck::run(int count, std::ostream &report, std::string reproducer) {
+    for(int c = 0; c < count; ++c){
+        std::vector<std::string> lines = randomworkload();
+        SimConfig cfg = randomconfig();
+        for(size_t e = 0; e < engines.size(); ++e){
+            if(difference(engines[e], lines, cfg).empty()) continue;
+            std::vector<std::string> shrunk = shrink(engines[e], lines, cfg);
+            std::ofstream out(reproducer);
+            out << joinlines(shrunk);
+            report << "Case " << c + 1 << " of " << count << ": the " << engines[e].name << " engine differs from the reference" << std::endl;
+            report << "Scheduling Algorithm: " << StatUpdater::algorithmname(cfg.algorithm) << std::endl;
+            report << "Shrunk from " << lines.size() << " to " << shrunk.size() << " processes, written to " << reproducer << std::endl;
+            report << "First difference: " << difference(engines[e], shrunk, cfg) << std::endl;
+            report << "Reference run: ./schedsim " << reproducer << " output.txt " << cfg.algorithm;
+            if(cfg.timeq > 0) report << " " << cfg.timeq;
+            if(cfg.algorithm == 4) report << " --seed " << cfg.seed;
+            if(cfg.algorithm == 6) report << " --boost " << cfg.boost;
+            if(cfg.algorithm == 7){
+                std::ofstream groups(reproducer + "-groups");
+                for(std::map<int, GroupShare>::const_iterator it = cfg.groups.begin(); it != cfg.groups.end(); ++it){
+                    groups << it->first << " " << it->second.shares << " " << it->second.quota << " " << it->second.period << "\n";
+                }
+                report << " --groups " << reproducer << "-groups";
+            }
+            report << std::endl;
+            return false;
+        }
+    }
+    report << count << " cases, " << engines.size() << " engines: every engine matched the reference" << std::endl;
+    return true;
+}
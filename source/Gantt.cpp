@@ -0,0 +1,97 @@
+#include "../headers/Gantt.h"
+#include <algorithm>
+#include <iomanip>
+#include <string>
+
+Gantt::Gantt(std::vector<GanttInterval> *out) {
+    intervals = out;
+}
+
+void Gantt::record(PCBStatus status) {
+    PROCESS_STATE state = status.getRecordedState();
+    float time = status.getRecordedCpuTime();
+    int pid = status.getPid();
+    if(state == CREATED) return;
+
+    std::unordered_map<int, Open>::iterator it = open.find(pid);
+    if(it != open.end()){
+        Open &o = it->second;
+        if(time > o.start){
+            GanttInterval *prev = o.last >= 0 ? &(*intervals)[o.last] : NULL;
+            if(prev != NULL && prev->state == o.state && prev->end == o.start) prev->end = time;
+            else {
+                GanttInterval closed = {pid, o.state, o.start, time};
+                o.last = intervals->size();
+                intervals->push_back(closed);
+            }
+        }
+        if(state == COMPLETED){
+            open.erase(it);
+            return;
+        }
+        o.state = state;
+        o.start = time;
+        return;
+    }
+    if(state == COMPLETED) return;
+    Open fresh = {state, time, -1};
+    open[pid] = fresh;
+}
+
+static const char* statename(PROCESS_STATE state) {
+    switch(state){
+        case IN_RUNNING_QUEUE:
+            return "running";
+        case IN_READY_QUEUE:
+            return "ready";
+        case IN_BLOCKED_QUEUE:
+            return "blocked";
+        default:
+            return "";
+    }
+}
+
+void Gantt::print(std::ostream &out, const std::vector<GanttInterval> &intervals) {
+    out << "pid,state,start,end" << "\n";
+    for(size_t i = 0; i < intervals.size(); ++i){
+        const GanttInterval &g = intervals[i];
+        out << g.pid << "," << statename(g.state) << "," << g.start << "," << g.end << "\n";
+    }
+}
+
+static bool compareRows(const GanttInterval *a, const GanttInterval *b) {
+    if(a->pid != b->pid) return a->pid < b->pid;
+    return a->start < b->start;
+}
+
+void Gantt::render(std::ostream &out, const std::vector<GanttInterval> &intervals, int width) {
+    if(intervals.empty() || width < 1) return;
+    std::vector<const GanttInterval*> rows(intervals.size());
+    float end = 0;
+    for(size_t i = 0; i < intervals.size(); ++i){
+        rows[i] = &intervals[i];
+        end = std::max(end, intervals[i].end);
+    }
+    std::sort(rows.begin(), rows.end(), compareRows);
+
+    // each column covers the same stretch of time and shows the state at its midpoint.
+    float cell = end / width;
+    int colwidth = 11;
+    out << std::left << std::setw(colwidth) << "PID" << "|0 ms" << std::string(std::max(1, width - 4 - int(std::to_string(int(end)).size()) - 3), ' ')
+        << int(end) << " ms|" << std::endl;
+    size_t i = 0;
+    while(i < rows.size()){
+        int pid = rows[i]->pid;
+        std::string line(width, ' ');
+        for(; i < rows.size() && rows[i]->pid == pid; ++i){
+            const GanttInterval *g = rows[i];
+            char mark = g->state == IN_RUNNING_QUEUE ? '#' : g->state == IN_READY_QUEUE ? '-' : '~';
+            for(int col = int(g->start / cell); col < width && col * cell < g->end; ++col){
+                // running wins any column it touches, so short bursts don't vanish between midpoints.
+                bool midpoint = (col + 0.5) * cell >= g->start && (col + 0.5) * cell < g->end;
+                if(mark == '#' || (midpoint && line[col] != '#')) line[col] = mark;
+            }
+        }
+        out << std::left << std::setw(colwidth) << pid << "|" << line << "|" << std::endl;
+    }
+}
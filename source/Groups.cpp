@@ -0,0 +1,36 @@
+#include "../headers/Groups.h"
+#include "../headers/SimError.h"
+#include <fstream>
+#include <sstream>
+
+std::map<int, GroupShare> Groups::read(std::string filename) {
+    std::ifstream file(filename);
+    if(!file) throw SimError("Can't open " + filename + ".");
+
+    std::map<int, GroupShare> groups;
+    std::string line;
+    while(std::getline(file, line)){
+        std::stringstream ss(line);
+        int group;
+        GroupShare share;
+        // blank lines are skipped the same as in a workload.
+        if(line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        if(!(ss >> group)) throw SimError("Bad group number in " + filename + ".");
+        if(!(ss >> share.shares)) throw SimError("Missing shares for group " + std::to_string(group) + ".");
+        // a failed read zeroes what it was reading into, so the optional columns go through locals.
+        float quota, period;
+        if(ss >> quota){
+            share.quota = quota;
+            if(ss >> period) share.period = period;
+        }
+        std::string extra;
+        if(ss.fail() && !ss.eof()) throw SimError("Bad quota or period for group " + std::to_string(group) + ".");
+        if(ss >> extra) throw SimError("Too many values for group " + std::to_string(group) + ".");
+        if(group < 0) throw SimError("Group can't be less than zero.");
+        if(share.shares <= 0 || share.quota < 0 || share.period <= 0){
+            throw SimError("Group " + std::to_string(group) + " needs shares and a period greater than 0 and a quota that isn't negative.");
+        }
+        if(!groups.insert(std::make_pair(group, share)).second) throw SimError("Group " + std::to_string(group) + " is listed twice.");
+    }
+    return groups;
+}
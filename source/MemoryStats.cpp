@@ -0,0 +1,69 @@
+#include "../headers/MemoryStats.h"
+#include <atomic>
+#include <iomanip>
+#include <sys/resource.h>
+
+static std::atomic<size_t> livebytes[MEM_SUBSYSTEMS];
+static std::atomic<size_t> peakbytes[MEM_SUBSYSTEMS];
+
+void MemoryStats::allocated(MemorySubsystem s, size_t bytes) {
+    size_t now = livebytes[s].fetch_add(bytes) + bytes;
+    size_t high = peakbytes[s].load();
+    //another thread may raise the peak between the load and the exchange, then compare again
+    while(now > high && !peakbytes[s].compare_exchange_weak(high, now));
+}
+
+void MemoryStats::released(MemorySubsystem s, size_t bytes) {
+    livebytes[s].fetch_sub(bytes);
+}
+
+size_t MemoryStats::live(MemorySubsystem s) {
+    return livebytes[s].load();
+}
+
+size_t MemoryStats::peak(MemorySubsystem s) {
+    return peakbytes[s].load();
+}
+
+size_t MemoryStats::peakrss() {
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    //linux reports kilobytes
+    return size_t(usage.ru_maxrss) * 1024;
+}
+
+std::string MemoryStats::name(MemorySubsystem s) {
+    switch(s){
+        case MEM_QUEUES:
+            return "Queues";
+        case MEM_PCBS:
+            return "Running PCBs";
+        case MEM_LIFECYCLE:
+            return "Lifecycle";
+        case MEM_LIFECYCLE_PRINT:
+            return "Lifecycle Table";
+        case MEM_VALIDATOR:
+            return "Input Pids";
+        case MEM_PHASES:
+            return "Listed Phases";
+        default:
+            return "";
+    }
+}
+
+void MemoryStats::print(std::ostream &out) {
+    int colwidth = 17;
+    out << "*******************************************************************" << std::endl;
+    out << "Memory Use (bytes)" << std::endl;
+    out << "*******************************************************************" << std::endl;
+    out << "----------------------------------------------------------" << std::endl;
+    out << "| " << std::left << std::setw(colwidth) << "Subsystem" << "| " << std::left << std::setw(colwidth) << "Live"
+        << "| " << std::left << std::setw(colwidth) << "Peak" << "| " << std::endl;
+    out << "----------------------------------------------------------" << std::endl;
+    for(int s = 0; s < MEM_SUBSYSTEMS; ++s){
+        out << "| " << std::left << std::setw(colwidth) << name(MemorySubsystem(s)) << "| " << std::left << std::setw(colwidth)
+            << live(MemorySubsystem(s)) << "| " << std::left << std::setw(colwidth) << peak(MemorySubsystem(s)) << "| " << std::endl;
+        out << "----------------------------------------------------------" << std::endl;
+    }
+    out << std::endl << "Peak Resident Set Size: " << peakrss() << std::endl;
+}
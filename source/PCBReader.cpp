@@ -0,0 +1,90 @@
+#include "../headers/PCBReader.h"
+#include "../headers/Phases.h"
+#include <cstdlib>
+
+
+PCBReader::PCBReader(std::istream &in) : table(new PhaseTable) {
+    input = &in;
+    ordered = unique = true;
+}
+
+PCBReader::PCBReader(std::string filename) : table(new PhaseTable) {
+    ordered = unique = true;
+    // "-" reads the workload from stdin so the simulator can sit at the end of a pipe.
+    // A FIFO is opened like any other file; reads on it block until the producer writes.
+    if(filename == "-") input = &std::cin;
+    else {
+        infile.open(filename);
+        input = &infile;
+    }
+}
+
+bool PCBReader::next(PCB &pcb){
+    // Read until there are no more lines.
+    if(input->eof()) return false;
+
+    std::stringstream ss;
+    std::string line;
+
+    // An important container for the line info.
+    // vals[0] = PID
+    // vals[1] = Arrival time
+    // vals[2] = Burst time
+    // vals[3] = Priority
+    // vals[4] = IO burst time
+    // vals[5] = deadline relative to arrival, optional, 0 or missing means none
+    float vals[6];
+    // group for group fair share, optional, only after a deadline column, missing means group 0
+    int group = 0;
+    float extra;
+    // the burst column can also list or generate a process's phases, see Phases.
+    std::string burst;
+
+    // skip blank lines; only an exhausted stream means no more processes are coming.
+    // a last record without a trailing newline still counts.
+    while(getline(*input, line) && line.length() <= 2);
+    if(line.length() <= 2) return false;
+
+    ss << line;
+    int count = 0;
+    // change from 4 to 5 to read the extra column,
+    while(count < 5 && (count == 2 ? ss >> burst : ss >> vals[count])){
+        count++;
+    };
+
+    //the columns have to be there before the values in them can be checked
+    if(ss.fail()) throw SimError("Missing data for process in file.");
+    if(!(ss >> vals[5])) vals[5] = 0;
+    else if(!(ss >> group)){
+        if(!ss.eof()) throw SimError("Group has to be a whole number.");
+        group = 0;
+    }
+    else if(ss >> extra) throw SimError("Too many values for a process in file.");
+
+    // create the PCB object.
+    pcb = PCB(vals[0], vals[1], 0, vals[3], vals[4], vals[5] != 0 ? int(vals[1]) + int(vals[5]) : -1);
+    pcb.group = group;
+    if(!Phases::parse(burst, pcb, *table)){
+        char *end;
+        vals[2] = strtof(burst.c_str(), &end);
+        if(*end != '\0') throw SimError("Missing data for process in file.");
+        pcb.burst = vals[2];
+        pcb.time_left = pcb.burst;
+    }
+    validator.check(pcb);
+    return true;
+}
+
+std::shared_ptr<PhaseTable> PCBReader::phases(){
+    return table;
+}
+
+void PCBReader::allowunsorted(){
+    ordered = false;
+    validator = PCBValidator(ordered, unique);
+}
+
+void PCBReader::skippidcheck(){
+    unique = false;
+    validator = PCBValidator(ordered, unique);
+}
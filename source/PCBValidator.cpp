@@ -0,0 +1,27 @@
+#include "../headers/PCBValidator.h"
+
+PCBValidator::PCBValidator(bool ordered_, bool unique_) {
+    last_arr = 0;
+    ordered = ordered_;
+    unique = unique_;
+}
+
+void PCBValidator::check(const PCB &pcb) {
+    if(pcb.pid < 0) throw SimError("PID can't be less than zero.");
+    if(pcb.arrival < 0) throw SimError("Arrival time can't be less than zero.");
+    if(pcb.burst <= 0) throw SimError("CPU Burst time must be greater than 0.");
+    if(pcb.phases.left > 0 && pcb.io_burst != 0) throw SimError("A process with phases takes its I/O from them, IOBurstTime has to be 0.");
+    if(pcb.group < 0) throw SimError("Group can't be less than zero.");
+    if(pcb.deadline != -1 && pcb.deadline <= pcb.arrival) throw SimError("Deadline must be after arrival time.");
+    if(ordered && pcb.arrival < last_arr) throw SimError("Processes need to be sorted by arrival time.");
+    if(unique && !pids.insert(pcb.pid).second) throw SimError("Can't have duplicate PIDs.");
+
+    //no error with data, remember it for the next ones
+    last_arr = pcb.arrival;
+}
+
+void PCBValidator::check(const std::vector<PCB> &workload) {
+    PCBValidator validator;
+    validator.pids.reserve(workload.size());
+    for(size_t i = 0; i < workload.size(); ++i) validator.check(workload[i]);
+}
@@ -0,0 +1,133 @@
+#include "../headers/Phases.h"
+#include "../headers/MemoryStats.h"
+#include "../headers/SimError.h"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <sstream>
+
+static const size_t BLOCK_SIZE = 1 << 16;
+//the largest mean a generator takes, so every burst drawn, up to 2 * mean - 1, fits in an int
+static const long MAX_MEAN = 1L << 30;
+
+PhaseTable::PhaseTable() : used(0), size(0), total(0) {}
+
+PhaseTable::~PhaseTable() {
+    for(size_t i = 0; i < blocks.size(); ++i) delete[] blocks[i];
+    MemoryStats::released(MEM_PHASES, total * sizeof(int));
+}
+
+const int* PhaseTable::add(const std::vector<int> &bursts) {
+    // a process's bursts are kept together, a list that doesn't fit in what is left of the block starts a new one.
+    if(bursts.size() > size - used){
+        size = bursts.size() > BLOCK_SIZE ? bursts.size() : BLOCK_SIZE;
+        blocks.push_back(new int[size]);
+        used = 0;
+        total += size;
+        MemoryStats::allocated(MEM_PHASES, size * sizeof(int));
+    }
+    int *first = blocks.back() + used;
+    for(size_t i = 0; i < bursts.size(); ++i) first[i] = bursts[i];
+    used += bursts.size();
+    return first;
+}
+
+//xorshift, uniform over 1 .. 2 * mean - 1 so the bursts average mean
+static int draw(unsigned &state, int mean) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return mean <= 1 ? 1 : 1 + int(state % (2u * unsigned(mean) - 1u));
+}
+
+//reads a whole number from 1 to limit at the start of text, returns 0 if there isn't one
+static long number(const char *text, const char *&end, long limit) {
+    char *after;
+    errno = 0;
+    long value = strtol(text, &after, 10);
+    end = after;
+    if(after == text || errno == ERANGE || value <= 0 || value > limit) return 0;
+    return value;
+}
+
+bool Phases::parse(const std::string &column, PCB &pcb, PhaseTable &table) {
+    if(column.find(',') != std::string::npos){
+        std::vector<int> bursts;
+        std::stringstream list(column);
+        std::string burst;
+        while(std::getline(list, burst, ',')){
+            const char *end;
+            long value = number(burst.c_str(), end, INT_MAX);
+            if(value == 0 || *end != '\0') throw SimError("Phase bursts must be whole numbers from 1 to " + std::to_string(INT_MAX) + ".");
+            bursts.push_back(int(value));
+        }
+        if(bursts.size() % 2 == 0) throw SimError("Phases have to start and end with a CPU burst.");
+        pcb.burst = bursts[0];
+        pcb.time_left = bursts[0];
+        pcb.phases.left = bursts.size() / 2;
+        pcb.phases.cpu = -1;
+        pcb.phases.io = 0;
+        bursts.erase(bursts.begin());
+        pcb.phases.listed = table.add(bursts);
+        return true;
+    }
+    if(!column.empty() && column[0] == 'g'){
+        const char *at = column.c_str() + 1;
+        long count = number(at, at, INT_MAX);
+        long cpu = count != 0 && *at == ':' ? number(at + 1, at, MAX_MEAN) : 0;
+        long io = cpu != 0 && *at == ':' ? number(at + 1, at, MAX_MEAN) : 0;
+        if(io == 0 || *at != '\0'){
+            throw SimError("Generated phases are written gN:C:I, with N greater than 0 and C and I from 1 to " + std::to_string(MAX_MEAN) + ".");
+        }
+        // every process gets its own sequence, the same one each time the workload is read.
+        unsigned state = unsigned(pcb.pid) * 2654435761u ^ 0x9e3779b9u;
+        if(state == 0) state = 1;
+        pcb.phases.left = count - 1;
+        pcb.phases.cpu = cpu;
+        pcb.phases.io = io;
+        pcb.burst = draw(state, cpu);
+        pcb.time_left = pcb.burst;
+        pcb.phases.next = state;
+        return true;
+    }
+    return false;
+}
+
+bool Phases::advance(PCB &pcb) {
+    if(pcb.phases.left <= 0) return false;
+    int io, cpu;
+    if(pcb.phases.cpu < 0){
+        io = pcb.phases.listed[0];
+        cpu = pcb.phases.listed[1];
+        pcb.phases.listed += 2;
+    }
+    else {
+        io = draw(pcb.phases.next, pcb.phases.io);
+        cpu = draw(pcb.phases.next, pcb.phases.cpu);
+    }
+    pcb.phases.left--;
+    pcb.io_burst = io;
+    pcb.time_left = cpu;
+    pcb.burst += cpu;
+    return true;
+}
+
+void Phases::fingerprint(const PCB &pcb, std::vector<int> &out) {
+    out.push_back(pcb.phases.left);
+    out.push_back(pcb.phases.cpu);
+    out.push_back(pcb.phases.io);
+    if(pcb.phases.cpu >= 0){
+        out.push_back(int(pcb.phases.next));
+        return;
+    }
+    // listed bursts are compared by value, the same list read twice lands at two places.
+    out.insert(out.end(), pcb.phases.listed, pcb.phases.listed + 2 * pcb.phases.left);
+}
+
+bool Phases::same(const PCB &a, const PCB &b) {
+    if(a.phases.left != b.phases.left || a.phases.cpu != b.phases.cpu) return false;
+    std::vector<int> x, y;
+    fingerprint(a, x);
+    fingerprint(b, y);
+    return x == y;
+}
@@ -0,0 +1,125 @@
+#include "../headers/Pipeline.h"
+#include "../headers/PCBReader.h"
+#include "../headers/StatUpdater.h"
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+Pipeline::Pipeline(size_t capacity) : input(capacity), output(capacity), readfailed(false) {}
+
+//reader stage, parses ahead of the simulation until the ring is full
+void Pipeline::readinput(std::string infile) {
+    try {
+        PCBReader reader(infile);
+        phases = reader.phases();
+        PCB pcb;
+        while(reader.next(pcb)) input.push(pcb);
+    }catch(SimError &e){
+        // the simulation stops at its next cycle, the error is passed on once every stage is done.
+        readerror = e.what();
+        readfailed = true;
+    }
+    input.close();
+}
+
+//writer stage, formats rows and transitions while the simulation keeps going
+void Pipeline::writeoutput(std::string outfile, SimConfig cfg) {
+    std::ofstream report(outfile);
+    std::ofstream events(outfile + "-events");
+
+    report << "*******************************************************************" << std::endl;
+    report << "Scheduling Algorithm: " << StatUpdater::algorithmname(cfg.algorithm) << std::endl;
+    if(cfg.timeq != -1) report << "(Quantum = " << cfg.timeq << ")" << std::endl;
+    report << "*******************************************************************" << std::endl;
+    StatUpdater::printheader(report);
+
+    SimSummary sum;
+    sum.num_tasks = sum.contexts = 0;
+    sum.avg_burst = sum.avg_wait = sum.avg_turn = sum.avg_resp = sum.finish_time = 0;
+    std::vector<float> lateness;
+
+    SimOutput item;
+    while(output.pop(item)){
+        if(item.isfinished){
+            StatUpdater::printrow(report, &item.pcb);
+            sum.num_tasks++;
+            sum.contexts += item.pcb.num_context;
+            sum.avg_burst += item.pcb.burst;
+            sum.avg_wait += item.pcb.wait_time;
+            sum.avg_turn += item.pcb.finish_time - item.pcb.arrival;
+            sum.avg_resp += item.pcb.resp_time;
+            if(item.pcb.finish_time > sum.finish_time) sum.finish_time = item.pcb.finish_time;
+            if(item.pcb.deadline >= 0) lateness.push_back(item.pcb.finish_time - item.pcb.deadline);
+            if(cfg.algorithm == 7) StatUpdater::countgroup(sum, item.pcb);
+        }
+        else events << item.status.toString() << "\n";
+    }
+
+    if(sum.num_tasks > 0){
+        sum.avg_burst /= sum.num_tasks;
+        sum.avg_wait /= sum.num_tasks;
+        sum.avg_turn /= sum.num_tasks;
+        sum.avg_resp /= sum.num_tasks;
+    }
+    StatUpdater::summarizedeadlines(sum, lateness);
+    if(cfg.algorithm == 7) StatUpdater::addgroupusage(sum, groupusage);
+    StatUpdater::printsummary(report, sum);
+
+    // the output ring is only closed once the reader is done, so readfailed is settled by now.
+    // a report over part of the input would pass for a complete one, so none is left behind, same as a plain run.
+    if(readfailed){
+        report.close();
+        events.close();
+        std::remove(outfile.c_str());
+        std::remove((outfile + "-events").c_str());
+    }
+}
+
+void Pipeline::run(std::string infile, std::string outfile, const SimConfig &cfg) {
+    std::thread reader(&Pipeline::readinput, this, infile);
+    std::thread writer(&Pipeline::writeoutput, this, outfile, cfg);
+
+    // the writer stage produces the report, so the simulation itself writes no files.
+    SimConfig simcfg = cfg;
+    simcfg.outfile = "";
+    simcfg.stream = NULL;
+    simcfg.sink = this;
+
+    Simulator sim;
+    SimResults results;
+    RingSource src(&input);
+    sim.begin(&src, simcfg, results);
+    while(!readfailed && sim.step());
+    sim.end(results);
+    for(std::map<int, GroupStats>::iterator it = results.summary.groups.begin(); it != results.summary.groups.end(); ++it) groupusage.push_back(it->second);
+    output.close();
+
+    reader.join();
+    writer.join();
+
+    if(readfailed) throw SimError(readerror);
+    if(cfg.telemetry > 0 && cfg.telemetry_stream == NULL){
+        std::ofstream telemetryfile(outfile + "-telemetry");
+        Telemetry::print(telemetryfile, results.telemetry);
+    }
+    if(cfg.gantt){
+        std::ofstream intervals(outfile + "-gantt");
+        Gantt::print(intervals, results.gantt);
+        std::ofstream chart(outfile + "-gantt-chart");
+        Gantt::render(chart, results.gantt, 100);
+    }
+}
+
+void Pipeline::finished(const PCB &pcb) {
+    SimOutput item;
+    item.isfinished = true;
+    item.pcb = pcb;
+    output.push(item);
+}
+
+void Pipeline::event(const PCBStatus &status) {
+    SimOutput item;
+    item.isfinished = false;
+    item.status = status;
+    output.push(item);
+}
@@ -0,0 +1,108 @@
+#include "../headers/Progress.h"
+#include "../headers/SimError.h"
+#include <cstdio>
+#include <cstring>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+Progress::Progress() : time(0), arrived(0), completed(0), ready(0), blocked(0), running(0),
+                       avg_wait(0), avg_turn(0), avg_resp(0), finished(false), stopping(false) {
+    wait = turn = resp = 0;
+    count = 0;
+    listener = -1;
+    started = std::chrono::steady_clock::now();
+}
+
+Progress::~Progress() {
+    stopping = true;
+    if(server.joinable()) server.join();
+    if(listener >= 0){
+        close(listener);
+        unlink(path.c_str());
+    }
+}
+
+void Progress::listen(std::string socketpath) {
+    path = socketpath;
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(path.empty() || path.size() >= sizeof(address.sun_path)) throw SimError("Can't use " + path + " as a socket path.");
+    strcpy(address.sun_path, path.c_str());
+
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(listener < 0) throw SimError("Can't make a socket at " + path + ".");
+    // a socket left behind by an earlier run would make bind fail.
+    unlink(path.c_str());
+    if(bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || ::listen(listener, 16) != 0){
+        close(listener);
+        listener = -1;
+        throw SimError("Can't make a socket at " + path + ".");
+    }
+    started = std::chrono::steady_clock::now();
+    server = std::thread(&Progress::serve, this);
+}
+
+//waits a tenth of a second at a time so it notices when the run is over
+void Progress::serve() {
+    while(!stopping){
+        struct pollfd waiting = {listener, POLLIN, 0};
+        if(poll(&waiting, 1, 100) <= 0) continue;
+        int client = accept(listener, NULL, NULL);
+        if(client < 0) continue;
+        std::string text = report();
+        // a client that hung up early is its own problem, the run carries on either way.
+        for(size_t sent = 0; sent < text.size();){
+            ssize_t n = send(client, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+            if(n <= 0) break;
+            sent += n;
+        }
+        close(client);
+    }
+}
+
+void Progress::processfinished(const PCB &pcb) {
+    count++;
+    wait += pcb.wait_time;
+    turn += pcb.finish_time - pcb.arrival;
+    resp += pcb.resp_time;
+    avg_wait.store(wait / count, std::memory_order_relaxed);
+    avg_turn.store(turn / count, std::memory_order_relaxed);
+    avg_resp.store(resp / count, std::memory_order_relaxed);
+}
+
+void Progress::update(float now, int emitted, int done, int readyqueue, int blockedqueue, bool busy) {
+    time.store(now, std::memory_order_relaxed);
+    arrived.store(emitted, std::memory_order_relaxed);
+    completed.store(done, std::memory_order_relaxed);
+    ready.store(readyqueue, std::memory_order_relaxed);
+    blocked.store(blockedqueue, std::memory_order_relaxed);
+    running.store(busy ? 1 : 0, std::memory_order_relaxed);
+}
+
+void Progress::end() {
+    finished = true;
+}
+
+std::string Progress::report() {
+    // each number is the latest on its own, a report taken mid-cycle can mix two neighbouring cycles.
+    double wall = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    float now = time.load(std::memory_order_relaxed);
+    std::ostringstream text;
+    text << "time_ms " << now << "\n"
+         << "wall_ms " << wall << "\n"
+         << "sim_per_wall " << (wall > 0 ? now / wall : 0) << "\n"
+         << "arrived " << arrived.load(std::memory_order_relaxed) << "\n"
+         << "completed " << completed.load(std::memory_order_relaxed) << "\n"
+         << "ready " << ready.load(std::memory_order_relaxed) << "\n"
+         << "blocked " << blocked.load(std::memory_order_relaxed) << "\n"
+         << "running " << running.load(std::memory_order_relaxed) << "\n"
+         << "avg_wait_ms " << avg_wait.load(std::memory_order_relaxed) << "\n"
+         << "avg_turnaround_ms " << avg_turn.load(std::memory_order_relaxed) << "\n"
+         << "avg_response_ms " << avg_resp.load(std::memory_order_relaxed) << "\n"
+         << "finished " << (finished ? 1 : 0) << "\n";
+    return text.str();
+}
@@ -0,0 +1,177 @@
+#include "../headers/QuantumOptimizer.h"
+#include "../headers/StatUpdater.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <thread>
+
+QuantumOptimizer::QuantumOptimizer(const std::vector<PCB> *w, SimConfig cfg, int obj, int max, int reps) {
+    workload = w;
+    config = cfg;
+    // evaluations stay in memory, only the search result gets written.
+    config.outfile = "";
+    config.stream = NULL;
+    config.telemetry = 0;
+    objective = obj;
+
+    maxq = max;
+    if(maxq <= 0){
+        // past the longest burst every process finishes within one quantum, so larger quanta change nothing.
+        maxq = 1;
+        for(size_t i = 0; i < workload->size(); ++i) maxq = std::max(maxq, (*workload)[i].burst);
+    }
+
+    // every other algorithm gives the same answer on every run.
+    replicas = 1;
+    if(config.algorithm == 4) replicas = reps > 0 ? reps : 10;
+
+    threads = std::thread::hardware_concurrency();
+    if(threads < 1) threads = 1;
+    for(int t = 0; t < threads; ++t) sims.push_back(new Simulator());
+}
+
+QuantumOptimizer::~QuantumOptimizer() {
+    for(size_t t = 0; t < sims.size(); ++t) delete sims[t];
+}
+
+int QuantumOptimizer::parseobjective(std::string name) {
+    if(name == "wait") return WAIT;
+    if(name == "turnaround") return TURNAROUND;
+    if(name == "p99") return P99_TURNAROUND;
+    if(name == "response") return RESPONSE;
+    if(name == "switches") return SWITCHES;
+    return -1;
+}
+
+std::string QuantumOptimizer::objectivename(int obj) {
+    switch(obj){
+        case WAIT:
+            return "Average Waiting Time";
+        case TURNAROUND:
+            return "Average Turnaround Time";
+        case P99_TURNAROUND:
+            return "99th Percentile Turnaround Time";
+        case RESPONSE:
+            return "Average Response Time";
+        case SWITCHES:
+            return "Context Switches";
+    }
+    return "";
+}
+
+double QuantumOptimizer::score(const SimResults &res) {
+    switch(objective){
+        case WAIT:
+            return res.summary.avg_wait;
+        case TURNAROUND:
+            return res.summary.avg_turn;
+        case RESPONSE:
+            return res.summary.avg_resp;
+        case SWITCHES:
+            return res.summary.contexts;
+        case P99_TURNAROUND: {
+            if(res.finished.empty()) return 0;
+            std::vector<float> turns(res.finished.size());
+            for(size_t i = 0; i < turns.size(); ++i) turns[i] = res.finished[i].finish_time - res.finished[i].arrival;
+            size_t rank = size_t(std::ceil(0.99 * turns.size())) - 1;
+            std::nth_element(turns.begin(), turns.begin() + rank, turns.end());
+            return turns[rank];
+        }
+    }
+    return 0;
+}
+
+//jobs are numbered quantum by quantum, replicas of the same quantum next to each other
+void QuantumOptimizer::worker(int t, const std::vector<int> *quanta, std::vector<double> *out, std::atomic<int> *next) {
+    SimResults res;
+    for(int i = (*next)++; i < int(out->size()); i = (*next)++){
+        SimConfig cfg = config;
+        cfg.timeq = (*quanta)[i / replicas];
+        cfg.replica = i % replicas;
+        WorkloadSource src(workload);
+        sims[t]->run(&src, cfg, res);
+        (*out)[i] = score(res);
+    }
+}
+
+//runs every quantum that hasn't been tried yet, spread over the worker threads
+void QuantumOptimizer::evaluate(std::vector<int> quanta) {
+    std::vector<int> todo;
+    for(size_t i = 0; i < quanta.size(); ++i)
+        if(scores.count(quanta[i]) == 0 && std::find(todo.begin(), todo.end(), quanta[i]) == todo.end()) todo.push_back(quanta[i]);
+    if(todo.empty()) return;
+
+    std::vector<double> out(todo.size() * replicas);
+    std::atomic<int> next(0);
+    std::vector<std::thread> pool;
+    int n = std::min(threads, int(out.size()));
+    for(int t = 0; t < n; ++t) pool.push_back(std::thread(&QuantumOptimizer::worker, this, t, &todo, &out, &next));
+    for(size_t t = 0; t < pool.size(); ++t) pool[t].join();
+
+    for(size_t i = 0; i < todo.size(); ++i){
+        double sum = 0;
+        for(int r = 0; r < replicas; ++r) sum += out[i * replicas + r];
+        scores[todo[i]] = sum / replicas;
+    }
+}
+
+int QuantumOptimizer::run() {
+    // coarse pass, geometric so short quanta (where most of the change happens) are sampled densely.
+    std::vector<int> grid;
+    int points = std::max(12, threads * 2);
+    for(int i = 0; i < points; ++i){
+        int q = int(std::round(std::pow(double(maxq), double(i) / (points - 1))));
+        if(grid.empty() || q > grid.back()) grid.push_back(q);
+    }
+    evaluate(grid);
+
+    // refinement, bisect the gaps between the best quantum and its evaluated neighbours until none are left.
+    while(true){
+        int best = grid[0];
+        for(std::map<int, double>::iterator it = scores.begin(); it != scores.end(); ++it)
+            if(it->second < scores[best]) best = it->first;
+
+        std::map<int, double>::iterator at = scores.find(best);
+        int lo = at == scores.begin() ? best : std::prev(at)->first;
+        int hi = std::next(at) == scores.end() ? best : std::next(at)->first;
+
+        // half the cores sample each side, every point is strictly inside a gap so each round makes progress.
+        std::vector<int> probe;
+        int per = std::max(1, threads / 2);
+        int gaps[2][2] = {{lo, best}, {best, hi}};
+        for(int g = 0; g < 2; ++g){
+            int a = gaps[g][0], b = gaps[g][1];
+            int count = std::min(per, b - a - 1);
+            for(int i = 1; i <= count; ++i) probe.push_back(a + int(std::round(double(b - a) * i / (count + 1))));
+        }
+        if(probe.empty()) return best;
+        evaluate(probe);
+    }
+}
+
+void QuantumOptimizer::print(std::string filename) {
+    int best = scores.begin()->first;
+    for(std::map<int, double>::iterator it = scores.begin(); it != scores.end(); ++it)
+        if(it->second < scores[best]) best = it->first;
+
+    int colwidth = 11;
+    std::ofstream outfile(filename);
+    outfile << "*******************************************************************" << std::endl;
+    outfile << "Scheduling Algorithm: " << StatUpdater::algorithmname(config.algorithm) << std::endl;
+    outfile << "(Quantum Search 1.." << maxq << " Minimizing " << objectivename(objective);
+    if(replicas > 1) outfile << " Mean Of " << replicas << " Runs";
+    outfile << ")" << std::endl;
+    outfile << "*******************************************************************" << std::endl;
+    outfile << "----------------------------" << std::endl;
+    outfile << "| " << std::left << std::setw(colwidth) << "Quantum" << "| " << std::left << std::setw(colwidth) << "Objective" << "| " << std::endl;
+    outfile << "----------------------------" << std::endl;
+    for(std::map<int, double>::iterator it = scores.begin(); it != scores.end(); ++it){
+        outfile << "| " << std::left << std::setw(colwidth) << it->first << "| " << std::left << std::setw(colwidth) << it->second << "| " << std::endl;
+        outfile << "----------------------------" << std::endl;
+    }
+    outfile << std::endl;
+    outfile << "Best Quantum: " << best << "\t\t" << objectivename(objective) << ": " << scores[best]
+            << "\t\tQuanta Evaluated: " << scores.size() << std::endl;
+}
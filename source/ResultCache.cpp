@@ -0,0 +1,111 @@
+#include "../headers/ResultCache.h"
+#include "../headers/Phases.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+ResultCache::ResultCache(std::string directory) {
+    dir = directory;
+    mkdir(dir.c_str(), 0755);
+}
+
+static void fnv(unsigned long long &hash, const void *data, size_t len) {
+    const unsigned char *bytes = (const unsigned char*)data;
+    for(size_t i = 0; i < len; ++i){
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+std::string ResultCache::key(const std::vector<PCB> &workload, const SimConfig &cfg) {
+    unsigned long long hash = 14695981039346656037ULL;
+    fnv(hash, SCHEDSIM_VERSION, strlen(SCHEDSIM_VERSION));
+    fnv(hash, &cfg.algorithm, sizeof(cfg.algorithm));
+    fnv(hash, &cfg.timeq, sizeof(cfg.timeq));
+    // only preemptive random draws from the generator, every other algorithm gives the same answer for any seed.
+    if(cfg.algorithm == 4){
+        fnv(hash, &cfg.seed, sizeof(cfg.seed));
+        fnv(hash, &cfg.replica, sizeof(cfg.replica));
+    }
+    if(cfg.algorithm == 6){
+        size_t levels = cfg.levels.size();
+        fnv(hash, &levels, sizeof(levels));
+        for(size_t i = 0; i < levels; ++i) fnv(hash, &cfg.levels[i], sizeof(cfg.levels[i]));
+        fnv(hash, &cfg.boost, sizeof(cfg.boost));
+    }
+    if(cfg.algorithm == 7){
+        size_t groups = cfg.groups.size();
+        fnv(hash, &groups, sizeof(groups));
+        for(std::map<int, GroupShare>::const_iterator it = cfg.groups.begin(); it != cfg.groups.end(); ++it){
+            fnv(hash, &it->first, sizeof(it->first));
+            fnv(hash, &it->second.shares, sizeof(it->second.shares));
+            fnv(hash, &it->second.quota, sizeof(it->second.quota));
+            fnv(hash, &it->second.period, sizeof(it->second.period));
+        }
+    }
+
+    // hash the fields one by one rather than the structs, padding and run-time fields aren't part of the workload.
+    size_t count = workload.size();
+    fnv(hash, &count, sizeof(count));
+    for(size_t i = 0; i < workload.size(); ++i){
+        const PCB &p = workload[i];
+        fnv(hash, &p.pid, sizeof(p.pid));
+        fnv(hash, &p.arrival, sizeof(p.arrival));
+        fnv(hash, &p.burst, sizeof(p.burst));
+        fnv(hash, &p.priority, sizeof(p.priority));
+        fnv(hash, &p.io_burst, sizeof(p.io_burst));
+        fnv(hash, &p.deadline, sizeof(p.deadline));
+        // only group fair share looks at groups, so the other algorithms keep their keys.
+        if(cfg.algorithm == 7) fnv(hash, &p.group, sizeof(p.group));
+        if(p.phases.left > 0){
+            std::vector<int> phases;
+            Phases::fingerprint(p, phases);
+            fnv(hash, phases.data(), phases.size() * sizeof(int));
+        }
+    }
+
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", hash);
+    return hex;
+}
+
+std::string ResultCache::path(std::string key, std::string kind) {
+    return dir + "/" + key + "." + kind;
+}
+
+bool ResultCache::copyfile(std::string from, std::string to) {
+    std::ifstream in(from, std::ios::binary);
+    if(!in) return false;
+    std::ofstream out(to, std::ios::binary);
+    out << in.rdbuf();
+    return bool(out);
+}
+
+bool ResultCache::fetch(std::string key, std::string outfile) {
+    // the report is stored last, so if it is there the lifecycle is too.
+    std::ifstream report(path(key, "report"));
+    if(!report) return false;
+    if(!copyfile(path(key, "lifecycle"), outfile + "-lifecycle")) return false;
+    return copyfile(path(key, "report"), outfile);
+}
+
+void ResultCache::store(std::string key, std::string outfile) {
+    // a name no other process or thread will pick, renamed over the real entry once it is complete.
+    static std::atomic<int> counter(0);
+    std::ostringstream tmp;
+    tmp << dir << "/." << key << "." << getpid() << "." << counter++ << ".tmp";
+
+    const char *kinds[2] = {"lifecycle", "report"};
+    const std::string sources[2] = {outfile + "-lifecycle", outfile};
+    for(int i = 0; i < 2; ++i){
+        if(!copyfile(sources[i], tmp.str()) || rename(tmp.str().c_str(), path(key, kinds[i]).c_str()) != 0){
+            remove(tmp.str().c_str());
+            return;
+        }
+    }
+}
@@ -1,11 +1,22 @@
 #include "../headers/Schedulers.h"
 #include "../headers/PCBStatus.h"
 #include<vector>
+#include<climits>
+#include<algorithm>
+#include<cmath>
 
 
 Scheduler::Scheduler() {
     next_pcb_index = -1;
+    next_pcb = NULL;
     ready_queue = NULL;
+    known = queued = 0;
+    nonempty = 0;
+    boost = sinceboost = 0;
+    clock = NULL;
+    minvruntime = 0;
+    charging = -1;
+    pending = 0;
 }
 
 //constructor for non-RR algs
@@ -14,16 +25,32 @@ Scheduler::Scheduler(DList<PCB> *rq, CPU *cp, int alg){
     cpu = cp;
     dispatcher = NULL;
     next_pcb_index = -1;
+    next_pcb = NULL;
     algorithm = alg;
+    known = queued = 0;
+    nonempty = 0;
+    boost = sinceboost = 0;
+    clock = NULL;
+    minvruntime = 0;
+    charging = -1;
+    pending = 0;
 }
 
 //constructor for RR alg
-Scheduler::Scheduler(DList<PCB> *rq, CPU *cp, int alg, int tq, std::vector<PCBStatus> *status){
+Scheduler::Scheduler(DList<PCB> *rq, CPU *cp, int alg, int tq, StatusVector *status){
     ready_queue = rq;
     cpu = cp;
     dispatcher = NULL;
     next_pcb_index = -1;
+    next_pcb = NULL;
     algorithm = alg;
+    known = queued = 0;
+    nonempty = 0;
+    boost = sinceboost = 0;
+    clock = NULL;
+    minvruntime = 0;
+    charging = -1;
+    pending = 0;
     timeq = timer = tq;
     lcVector = status;
 }
@@ -34,20 +61,69 @@ void Scheduler::setdispatcher(Dispatcher *disp) {
     if(dispatcher == NULL) dispatcher = disp;
 }
 
+//seeds the generator preemptive random draws from, same seed and replica give the same schedule
+//both go through seed_seq so neighbouring seeds or replicas still start from unrelated states
+void Scheduler::setseed(unsigned seed, unsigned replica) {
+    std::seed_seq seq{seed, replica};
+    rng.seed(seq);
+}
+
+void Scheduler::setlevels(const std::vector<float> &quanta_, float boost_) {
+    quanta = quanta_;
+    levels.assign(quanta.size(), std::deque<PCB*>());
+    nonempty = 0;
+    boost = boost_;
+    sinceboost = 0;
+}
+
+void Scheduler::setgroups(const std::map<int, GroupShare> &config, Clock *cl) {
+    shares = config;
+    clock = cl;
+    // the listed groups are in the report even if none of their processes show up.
+    for(std::map<int, GroupShare>::const_iterator it = shares.begin(); it != shares.end(); ++it) findgroup(it->first);
+}
+
+const std::vector<GroupStats>& Scheduler::getgroupusage() {
+    return groupusage;
+}
+
 //dispatcher uses this to determine which process in the queue to grab
 int Scheduler::getnext() {
     return next_pcb_index;
 }
 
+//only earliest deadline first hands over the process itself, NULL means use getnext
+PCB* Scheduler::getnextpcb() {
+    return next_pcb;
+}
+
+void Scheduler::reindex() {
+    deadlines = std::priority_queue<DeadlineEntry, std::vector<DeadlineEntry>, std::greater<DeadlineEntry> >();
+    for(size_t level = 0; level < levels.size(); ++level) levels[level].clear();
+    nonempty = 0;
+    // the groups keep their place in the runnable set, their processes come back in ready queue order.
+    for(size_t g = 0; g < groups.size(); ++g) groups[g].ready.clear();
+    known = 0;
+    next_pcb = NULL;
+}
+
 //switch for the different algorithms
 void Scheduler::execute() {
     // decrement the timer (which counts backward) by one clock cycle, viz, 0.5.
     if(timer > 0) {
         timer -= .5;
     };
+
+    // the multi-level feedback queue lifts everything back to the top every boost ms, even with nothing waiting.
+    if(algorithm == 6 && boost > 0){
+        sinceboost += .5;
+        if(sinceboost >= boost) boostlevels();
+    }
     
+    // group fair share keeps count of the running group's time and quota every cycle, even with nothing waiting.
+    if(algorithm == 7) gfs();
     // if the ready queue has something in it, switch between the algorithm choices.
-    if(ready_queue->size()) {
+    else if(ready_queue->size()) {
         switch (algorithm) {
             case 0:
                 fcfs();
@@ -64,6 +140,12 @@ void Scheduler::execute() {
             case 4:
                 pr();
                 break;
+            case 5:
+                edf();
+                break;
+            case 6:
+                mlfq();
+                break;
             default:
                 break;
         }
@@ -161,11 +243,241 @@ void Scheduler::pr() {
 
         // randomly select the next index from the ready queue.
         int maxIndex = ready_queue->size();
-        next_pcb_index = rand() % maxIndex;
+        next_pcb_index = std::uniform_int_distribution<int>(0, maxIndex - 1)(rng);
         dispatcher->interrupt();
     }
 }
 
+void Scheduler::indexnew(void (Scheduler::*insert)(PCB*)) {
+    for(; known < ready_queue->size(); ++known) (this->*insert)(ready_queue->getindex(known));
+}
+
+void Scheduler::picked(PCB *pcb) {
+    next_pcb = pcb;
+    known--;
+    dispatcher->interrupt();
+}
+
+void Scheduler::insertdeadline(PCB *pcb) {
+    DeadlineEntry entry;
+    entry.deadline = pcb->deadline >= 0 ? pcb->deadline : INT_MAX;
+    entry.order = queued++;
+    entry.pcb = pcb;
+    deadlines.push(entry);
+}
+
+/**
+ * Earliest deadline first. The process whose deadline comes first runs, and a newly ready process with an
+ * earlier deadline than the running one preempts it. Processes without a deadline only run when no process
+ * with one is ready, in the order they became ready. The heap makes each decision O(log n) instead of a
+ * scan of the ready queue.
+*/
+void Scheduler::edf() {
+    indexnew(&Scheduler::insertdeadline);
+
+    const DeadlineEntry &first = deadlines.top();
+    int running = !cpu->isidle() && cpu->getpcb()->deadline >= 0 ? cpu->getpcb()->deadline : INT_MAX;
+    if(cpu->isidle() || first.deadline < running){
+        PCB *pcb = first.pcb;
+        deadlines.pop();
+        picked(pcb);
+    }
+}
+
+//at the back of its level
+void Scheduler::insertlevel(PCB *pcb) {
+    if(pcb->level >= int(levels.size())) pcb->level = levels.size() - 1;
+    levels[pcb->level].push_back(pcb);
+    nonempty |= 1ULL << pcb->level;
+}
+
+//every process, waiting or running, goes back to level 0 so long-running ones can't starve
+void Scheduler::boostlevels() {
+    sinceboost = 0;
+    indexnew(&Scheduler::insertlevel);
+    for(size_t level = 1; level < levels.size(); ++level){
+        for(size_t i = 0; i < levels[level].size(); ++i){
+            levels[level][i]->level = 0;
+            levels[0].push_back(levels[level][i]);
+        }
+        levels[level].clear();
+    }
+    nonempty = levels[0].empty() ? 0 : 1;
+    if(!cpu->isidle()) cpu->getpcb()->level = 0;
+}
+
+/**
+ * Multi-level feedback queue. The first process of the highest non-empty level runs for that level's quantum.
+ * A process that uses up its quantum drops a level, one that leaves for the blocked queue (after the first half
+ * of its quantum, the same as preemptive priority) comes back a level higher, and one that is preempted by a
+ * higher level keeps its own. Short, I/O heavy processes stay near the top and long CPU bound ones sink.
+*/
+void Scheduler::mlfq() {
+    indexnew(&Scheduler::insertlevel);
+
+    PCB *running = cpu->isidle() ? NULL : cpu->getpcb();
+    bool isIONeeded = running != NULL && running->io_burst > 0 && timer <= quanta[running->level] / 2;
+    int top = __builtin_ctzll(nonempty);
+    if(running != NULL && !isIONeeded && timer > 0 && top >= running->level) return;
+
+    if(running != NULL){
+        // the dispatcher sends anything with I/O left to the blocked queue.
+        if(running->io_burst > 0) running->level = std::max(0, running->level - 1);
+        else if(timer <= 0) running->level = std::min(int(levels.size()) - 1, running->level + 1);
+    }
+    PCB *pcb = levels[top].front();
+    levels[top].pop_front();
+    if(levels[top].empty()) nonempty &= ~(1ULL << top);
+    timer = quanta[pcb->level];
+    picked(pcb);
+}
+
+//the group's state, added the first time one of its processes or its line in --groups is seen
+size_t Scheduler::findgroup(int group) {
+    std::unordered_map<int, size_t>::iterator found = groupindex.find(group);
+    if(found != groupindex.end()) return found->second;
+    GroupState state;
+    std::map<int, GroupShare>::iterator listed = shares.find(group);
+    if(listed != shares.end()) state.share = listed->second;
+    state.vruntime = 0;
+    state.used = state.periodstart = state.since = state.release = 0;
+    state.stalled = -1;
+    state.queued = state.throttled = false;
+    groups.push_back(state);
+    GroupStats usage;
+    usage.group = group;
+    usage.share = state.share;
+    groupusage.push_back(usage);
+    groupindex[group] = groups.size() - 1;
+    return groups.size() - 1;
+}
+
+//at the back of its group
+void Scheduler::insertgroup(PCB *pcb) {
+    size_t g = findgroup(pcb->group);
+    GroupState &group = groups[g];
+    group.ready.push_back(pcb);
+    if(group.throttled){
+        if(group.stalled < 0) group.stalled = clock->gettime();
+    }
+    else if(!group.queued) activate(g);
+}
+
+void Scheduler::activate(size_t g) {
+    GroupState &group = groups[g];
+    group.vruntime = std::max(group.vruntime, minvruntime);
+    group.queued = true;
+    runnable.insert(std::make_pair(group.vruntime, g));
+}
+
+//adds the cpu time the running group has had since it was last moved in the runnable set to its virtual runtime
+void Scheduler::settle() {
+    if(charging < 0 || pending == 0) return;
+    GroupState &group = groups[charging];
+    if(group.queued) runnable.erase(std::make_pair(group.vruntime, size_t(charging)));
+    group.vruntime += pending / group.share.shares;
+    if(group.queued) runnable.insert(std::make_pair(group.vruntime, size_t(charging)));
+    pending = 0;
+}
+
+//counts the cycle about to run against g, throttling it once it has used up its quota for the period
+void Scheduler::charge(size_t g) {
+    if(charging != int(g)){
+        settle();
+        charging = g;
+    }
+    pending += .5;
+    groupusage[g].cpu_time += .5;
+
+    GroupState &group = groups[g];
+    if(group.share.quota <= 0) return;
+    float now = clock->gettime();
+    // periods are only caught up with when the group runs, one that sat idle just starts a fresh one.
+    if(now >= group.periodstart + group.share.period){
+        group.periodstart = std::floor(now / group.share.period) * group.share.period;
+        group.used = 0;
+    }
+    group.used += .5;
+    group.release = group.periodstart + group.share.period;
+    // a quota as long as the period can't be used up before the period ends.
+    if(group.used < group.share.quota || group.release <= now + .5) return;
+    group.throttled = true;
+    group.since = now + .5;
+    if(!group.ready.empty()) group.stalled = group.since;
+    releases.push(std::make_pair(group.release, g));
+    groupusage[g].throttles++;
+    if(group.queued){
+        runnable.erase(std::make_pair(group.vruntime, g));
+        group.queued = false;
+    }
+}
+
+/**
+ * Group fair share. Every process belongs to a group and the CPU is split between the groups with something to
+ * run in proportion to their shares: the group whose CPU time divided by its shares is the lowest runs next, and
+ * within a group processes take turns a time quantum at a time, the same as round robin. A group with a quota is
+ * throttled once its processes have run for that long in the current period, its running process is taken off
+ * the CPU and none of them run again until the next period starts, even if the CPU has nothing else to do.
+ * Picking a group is O(log g) in the groups with something to run, and a cycle that doesn't pick one is O(1).
+*/
+void Scheduler::gfs() {
+    float now = clock->gettime();
+    // groups whose period came round get their quota back before anything is picked.
+    while(!releases.empty() && releases.top().first <= now){
+        size_t g = releases.top().second;
+        releases.pop();
+        GroupState &group = groups[g];
+        group.throttled = false;
+        group.used = 0;
+        group.periodstart = group.release;
+        if(group.stalled >= 0){
+            groupusage[g].throttled_time += group.release - group.stalled;
+            group.stalled = -1;
+        }
+        if(!group.ready.empty()) activate(g);
+    }
+    indexnew(&Scheduler::insertgroup);
+
+    PCB *running = cpu->isidle() ? NULL : cpu->getpcb();
+    bool throttled = running != NULL && groups[charging].throttled;
+    if(running != NULL && !throttled && timer > 0){
+        charge(charging);
+        return;
+    }
+
+    settle();
+    if(throttled && groups[charging].stalled < 0) groups[charging].stalled = groups[charging].since;
+    if(running != NULL && !throttled && !groups[charging].queued
+       && (runnable.empty() || groups[charging].vruntime <= runnable.begin()->first)){
+        // no other group is further behind and its own group has nothing else waiting, so it goes on running.
+        minvruntime = std::max(minvruntime, groups[charging].vruntime);
+        timer = timeq;
+        charge(charging);
+        return;
+    }
+    if(runnable.empty()){
+        // everything waiting is in a throttled group, a throttled process still has to leave the cpu.
+        if(throttled){
+            dispatcher->preempt();
+            charging = -1;
+        }
+        return;
+    }
+
+    size_t g = runnable.begin()->second;
+    GroupState &group = groups[g];
+    minvruntime = std::max(minvruntime, group.vruntime);
+    PCB *pcb = group.ready.front();
+    group.ready.pop_front();
+    if(group.ready.empty()){
+        runnable.erase(runnable.begin());
+        group.queued = false;
+    }
+    timer = timeq;
+    picked(pcb);
+    charge(g);
+}
+
 /*
  *
  * Dispatcher Implementation
@@ -177,23 +489,28 @@ Dispatcher::Dispatcher(){
     ready_queue = NULL;
     clock = NULL;
     _interrupt = false;
+    _preempt = false;
     blocked_queue = NULL;
+    switches = 0;
 }
 
-Dispatcher::Dispatcher(CPU *cp, Scheduler *sch, DList<PCB> *rq, Clock *cl, DList<PCB> *bq, std::vector<PCBStatus> *vec) {
+Dispatcher::Dispatcher(CPU *cp, Scheduler *sch, DList<PCB> *rq, Clock *cl, DList<PCB> *bq, StatusVector *vec) {
     cpu = cp;
     scheduler = sch;
     ready_queue = rq;
     clock = cl;
     _interrupt = false;
+    _preempt = false;
     blocked_queue = bq;
     lcVector = vec;
+    switches = 0;
 };
 
 //function to handle switching out pcbs and storing back into ready queue
 PCB* Dispatcher::switchcontext(int index) {
     PCB* old_pcb = cpu->pcb;
-    PCB* new_pcb = new PCB(ready_queue->removeindex(scheduler->getnext()));
+    PCB* chosen = scheduler->getnextpcb();
+    PCB* new_pcb = new PCB(chosen != NULL ? ready_queue->remove(chosen) : ready_queue->removeindex(scheduler->getnext()));
     cpu->pcb = new_pcb;
     return old_pcb;
 }
@@ -206,30 +523,11 @@ void Dispatcher::execute() {
         if(old_pcb != NULL){ //only consider it a switch if cpu was still working on process
             // Increment the number of context switches for the old process.
             old_pcb->num_context++;
+            switches++;
             // Simulate a clock cycle overhead for context switching.
             cpu->getpcb()->wait_time += .5;
             clock->step();
-
-            // move the current pcb to the blocked queue IF burst time is > 0.
-            if (old_pcb->io_burst > 0 && blocked_queue != nullptr) {
-                
-                // Capture the state transition.
-                PCBStatus status(PROCESS_STATE::IN_BLOCKED_QUEUE, clock->gettime(), old_pcb->pid);
-                lcVector->push_back(status);
-
-                // move this to the end of the blocked queue.
-                blocked_queue->add_end(*old_pcb);
-
-            } else {
-                // Capture the state transition.
-                PCBStatus status(PROCESS_STATE::IN_READY_QUEUE, clock->gettime(), old_pcb->pid);
-                lcVector->push_back(status);
-                
-                // Add this to the end of the ready queue.
-                ready_queue->add_end(*old_pcb);
-            }
-
-            delete old_pcb;
+            requeue(old_pcb);
         }
 
         // Capture the state transition.
@@ -237,10 +535,52 @@ void Dispatcher::execute() {
         lcVector->push_back(status);
         _interrupt = false;
     }
+
+    // nothing is loaded, so there is no switching overhead, but the process still had its run cut short.
+    if(_preempt) {
+        PCB* old_pcb = cpu->pcb;
+        cpu->pcb = NULL;
+        cpu->idle = true;
+        old_pcb->num_context++;
+        switches++;
+        requeue(old_pcb);
+        _preempt = false;
+    }
+}
+
+void Dispatcher::requeue(PCB *old_pcb) {
+    // move the current pcb to the blocked queue IF burst time is > 0.
+    if (old_pcb->io_burst > 0 && blocked_queue != nullptr) {
+
+        // Capture the state transition.
+        PCBStatus status(PROCESS_STATE::IN_BLOCKED_QUEUE, clock->gettime(), old_pcb->pid);
+        lcVector->push_back(status);
+
+        // move this to the end of the blocked queue.
+        blocked_queue->add_end(*old_pcb);
+
+    } else {
+        // Capture the state transition.
+        PCBStatus status(PROCESS_STATE::IN_READY_QUEUE, clock->gettime(), old_pcb->pid);
+        lcVector->push_back(status);
+
+        // Add this to the end of the ready queue.
+        ready_queue->add_end(*old_pcb);
+    }
+
+    delete old_pcb;
+}
+
+int Dispatcher::getswitches() {
+    return switches;
 }
 
 //routine for scheudler to interrupt it
 void Dispatcher::interrupt() {
     // Simply toggle the interrupt flag.
     _interrupt = true;
+}
+
+void Dispatcher::preempt() {
+    _preempt = true;
 }
\ No newline at end of file
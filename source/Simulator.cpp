@@ -0,0 +1,356 @@
+#include "../headers/Simulator.h"
+#include "../headers/PCBGenerator.h"
+#include "../headers/CPU.h"
+#include "../headers/Schedulers.h"
+#include "../headers/PCBValidator.h"
+#include "../headers/ArrivalSorter.h"
+#include "../headers/SimError.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+// Placeholder function to manage blocked queue.
+void Simulator::serveIO(Clock *clock) {
+    DList<PCB> *rq = &ready_queue;
+    DList<PCB> *bq = &blocked_queue;
+
+    // Only perform ops if the blocked queue has any elements at all.
+    if (bq->size()) {
+
+        // this loop will ONLY look at processes with io_burst <= 0 and move them to the ready queue.
+        for (int i=0; i < bq->size(); ++i) {
+            if (bq->getindex(i)->io_burst <= 0) {
+                
+                // Capture the state transition.
+                PCBStatus status(PROCESS_STATE::IN_READY_QUEUE, clock->gettime(), bq->getindex(i)->pid);
+                lifeCycleVector.push_back(status);
+                // move this process to the ready queue.
+                rq->add_end(*bq->getindex(i));
+                bq->removeindex(i);
+
+                // decrement i by one to account for the deletion of a node.
+                i--;
+            }
+        }
+
+        // This loop will go over every process in the blocked queue and decrement their IO time by 0.5.
+        for (int i=0; i<bq->size(); ++i) {
+            // Decrement all the burst times by 0.5.
+            bq->getindex(i)->io_burst -= 0.5;
+        }
+    }
+}
+
+//every component of a run, kept together so a run can be copied part way through
+//the components point at each other, a copy keeps pointing at the components of the engine it was copied
+//from, so copies are only ever assigned back to the engine they were taken from
+struct SimEngine{
+    // Acts as the CPU clock.
+    Clock clock;
+    // A process generator. Pulls every process from the source. If their CPU clock >= arrival_time,
+    // the PCB object is placed on the ready queue.
+    PCBGenerator pgen;
+    // A utility to update core statistics.
+    StatUpdater stats;
+    // The CPU simulation.
+    CPU cpu;
+    // The heart of the code. Switch between multiple algorithms and decide how the CPU will consume the
+    // processes from the ready queue.
+    Scheduler scheduler;
+    // Another vital utility that manages context switches.
+    Dispatcher dispatcher;
+    // Samples queue depths and utilization over time, only runs if an interval was given.
+    Telemetry telemetry;
+    // Turns the state transitions into per-process intervals, only runs if asked for.
+    Gantt gantt;
+
+    SimEngine(PCBSource *src, DList<PCB> *rq, DList<PCB> *fq, DList<PCB> *bq, StatusVector *lc,
+              const SimConfig &cfg, TelemetrySeries *series, std::vector<GanttInterval> *intervals) :
+            pgen(src, rq, &clock, lc),
+            stats(rq, fq, &clock, cfg.algorithm, cfg.outfile, cfg.timeq, lc),
+            cpu(fq, bq, &clock, lc),
+            scheduler(rq, &cpu, cfg.algorithm, cfg.timeq, lc),
+            dispatcher(&cpu, &scheduler, rq, &clock, bq, lc),
+            telemetry(rq, bq, &cpu, &dispatcher, &clock, cfg.telemetry, series, cfg.telemetry_stream),
+            gantt(intervals) {
+        if(cfg.stream != NULL) stats.setstream(cfg.stream);
+        scheduler.setseed(cfg.seed, cfg.replica);
+        if(cfg.algorithm == 6){
+            stats.setleveltime(&cpu.getleveltime());
+            std::vector<float> quanta = cfg.levels;
+            if(quanta.empty()){
+                for(int level = 0; level < 3; ++level) quanta.push_back(cfg.timeq * float(1 << level));
+            }
+            scheduler.setlevels(quanta, cfg.boost);
+        }
+        if(cfg.algorithm == 7){
+            scheduler.setgroups(cfg.groups, &clock);
+            stats.setgroupusage(&scheduler.getgroupusage());
+        }
+        scheduler.setdispatcher(&dispatcher);
+    }
+};
+
+SimSnapshot::~SimSnapshot() {
+    delete engine;
+}
+
+Simulator::~Simulator() {
+    delete engine;
+    delete spilled;
+}
+
+void Simulator::begin(PCBSource *src, const SimConfig &cfg, SimResults &results) {
+    if(cfg.algorithm == 6){
+        bool valid = cfg.levels.size() <= 64 && (!cfg.levels.empty() || cfg.timeq > 0);
+        for(size_t level = 0; level < cfg.levels.size(); ++level) valid = valid && cfg.levels[level] > 0;
+        if(!valid) throw SimError("The multi-level feedback queue needs 1 to 64 levels with quanta greater than 0.");
+    }
+    if(cfg.algorithm == 7 && cfg.timeq <= 0) throw SimError("Group fair share needs a time quantum greater than 0.");
+
+    // start from empty queues, whatever a previous run left behind is dropped.
+    ready_queue.clear();
+    finished_queue.clear();
+    blocked_queue.clear();
+    lifeCycleVector.clear();
+
+    config = cfg;
+    results.telemetry.clear();
+    results.gantt.clear();
+    delete engine;
+    // the generator pulls the first process as it is built, so the engine can throw SimError half made.
+    engine = NULL;
+    engine = new SimEngine(src, &ready_queue, &finished_queue, &blocked_queue, &lifeCycleVector, config, &results.telemetry, &results.gantt);
+
+    // finished processes leave memory as they finish, the report is built from the file at the end.
+    delete spilled;
+    spilled = NULL;
+    if(cfg.spill > 0){
+        spilled = new SpillFile("");
+        spillsum = SimSummary();
+        lateness.clear();
+    }
+
+    // nobody will look at the transitions, so only keep the ones from the current cycle around.
+    // a spilled run has no lifecycle file, it would need every transition kept.
+    keeplifecycle = cfg.lifecycle || (!cfg.outfile.empty() && cfg.spill == 0);
+    // how much has already been handed to the sink.
+    sentfinished = 0;
+    sentevents = 0;
+    recorded = 0;
+    published = 0;
+    unchanged = INT_MAX;
+}
+
+bool Simulator::step() {
+    SimEngine &e = *engine;
+    //keep going until no more processes are going to be generated,
+    // no more in ready queue, no more in blocked queue, and cpu is done
+    if(e.pgen.finished() && !ready_queue.size() && e.cpu.isidle() && !blocked_queue.size()) return false;
+
+    size_t cyclestart = lifeCycleVector.size();
+    e.pgen.generate();
+    e.scheduler.execute();
+    e.dispatcher.execute();
+    e.cpu.execute();
+    serveIO(&e.clock);
+    e.stats.execute();
+    e.clock.step();
+    orderevents(cyclestart);
+    if(config.telemetry > 0) e.telemetry.execute();
+    if(config.gantt){
+        for(; recorded < lifeCycleVector.size(); ++recorded) e.gantt.record(lifeCycleVector[recorded]);
+    }
+    if(config.sink != NULL){
+        // the cpu terminates at most one process per cycle and it always lands at the tail.
+        if(e.cpu.getcompleted() > sentfinished){
+            config.sink->finished(*finished_queue.gettail());
+            sentfinished++;
+        }
+        for(; sentevents < lifeCycleVector.size(); ++sentevents) config.sink->event(lifeCycleVector[sentevents]);
+    }
+    if(config.progress != NULL){
+        // before a spill takes the finished process out of the queue.
+        if(e.cpu.getcompleted() > published){
+            config.progress->processfinished(*finished_queue.gettail());
+            published++;
+        }
+        config.progress->update(e.clock.gettime(), e.pgen.getemitted(), published, ready_queue.size(), blocked_queue.size(), !e.cpu.isidle());
+    }
+    if(spilled != NULL) spillfinished();
+    if(!keeplifecycle){
+        lifeCycleVector.clear();
+        sentevents = 0;
+        recorded = 0;
+    }
+    return true;
+}
+
+void Simulator::end(SimResults &results) {
+    SimEngine &e = *engine;
+    if(config.telemetry > 0) e.telemetry.finish();
+    if(config.progress != NULL) config.progress->end();
+
+    if(spilled != NULL){
+        if(spillsum.num_tasks > 0){
+            spillsum.avg_burst /= spillsum.num_tasks;
+            spillsum.avg_wait /= spillsum.num_tasks;
+            spillsum.avg_turn /= spillsum.num_tasks;
+            spillsum.avg_resp /= spillsum.num_tasks;
+        }
+        StatUpdater::summarizedeadlines(spillsum, lateness);
+        if(config.algorithm == 6) spillsum.level_time = e.cpu.getleveltime();
+        if(config.algorithm == 7) StatUpdater::addgroupusage(spillsum, e.scheduler.getgroupusage());
+        std::vector<float>().swap(lateness);
+    }
+
+    //print stats when the simulation is done and the accumulator data structures have data.
+    if(!config.outfile.empty()){
+        if(spilled != NULL) printspilled();
+        else {
+            e.stats.print();
+            e.stats.printProcessLifecycle();
+        }
+        if(config.telemetry > 0 && config.telemetry_stream == NULL){
+            std::ofstream outfile(config.outfile + "-telemetry");
+            Telemetry::print(outfile, results.telemetry);
+        }
+        if(config.gantt){
+            std::ofstream intervals(config.outfile + "-gantt");
+            Gantt::print(intervals, results.gantt);
+            std::ofstream chart(config.outfile + "-gantt-chart");
+            Gantt::render(chart, results.gantt, 100);
+        }
+    }
+
+    // hand the results over, the finished queue stays put in case a snapshot is restored later.
+    results.finished.clear();
+    for(int index = 0; index < finished_queue.size(); ++index) results.finished.push_back(*finished_queue.getindex(index));
+    if(spilled != NULL) results.summary = spillsum;
+    else {
+        results.summary = StatUpdater::summarize(results.finished);
+        if(config.algorithm == 6){
+            for(size_t index = 0; index < results.finished.size(); ++index) StatUpdater::countlevel(results.summary, results.finished[index]);
+        }
+        if(config.algorithm == 7){
+            StatUpdater::addgroupusage(results.summary, e.scheduler.getgroupusage());
+            for(size_t index = 0; index < results.finished.size(); ++index) StatUpdater::countgroup(results.summary, results.finished[index]);
+        }
+    }
+    if(config.algorithm == 6) results.summary.level_time = e.cpu.getleveltime();
+    if(config.lifecycle) results.lifecycle.assign(lifeCycleVector.begin(), lifeCycleVector.end());
+    else results.lifecycle.clear();
+}
+
+void Simulator::refill(PCBSource *src) {
+    if(engine->pgen.finished()) engine->pgen.setsource(src);
+}
+
+//puts the transitions recorded since first in order of time, the ones at the same time staying in the order they
+//were recorded. nothing a cycle records is earlier than what the cycles before it did, the dispatcher's and cpu's
+//extra half ms only get ahead of the rest of their own cycle, so this is an insertion over a handful of entries
+//and the whole vector stays sorted without ever being sorted as a whole
+void Simulator::orderevents(size_t first) {
+    for(size_t index = first + 1; index < lifeCycleVector.size(); ++index){
+        PCBStatus status = lifeCycleVector[index];
+        size_t place = index;
+        for(; place > first && lifeCycleVector[place - 1].getRecordedCpuTime() > status.getRecordedCpuTime(); --place){
+            lifeCycleVector[place] = lifeCycleVector[place - 1];
+        }
+        lifeCycleVector[place] = status;
+    }
+}
+
+//moves whatever finished this cycle to the spill file, adding it to the totals on the way
+void Simulator::spillfinished() {
+    while(finished_queue.size()){
+        PCB done = finished_queue.remove_head();
+        spillsum.num_tasks++;
+        spillsum.contexts += done.num_context;
+        spillsum.avg_burst += done.burst;
+        spillsum.avg_wait += done.wait_time;
+        spillsum.avg_turn += done.finish_time - done.arrival;
+        spillsum.avg_resp += done.resp_time;
+        if(done.deadline >= 0) lateness.push_back(done.finish_time - done.deadline);
+        if(done.finish_time > spillsum.finish_time) spillsum.finish_time = done.finish_time;
+        if(config.algorithm == 6) StatUpdater::countlevel(spillsum, done);
+        if(config.algorithm == 7) StatUpdater::countgroup(spillsum, done);
+        spilled->write(done);
+    }
+}
+
+//the same report StatUpdater::print writes, in one pass over the spilled processes sorted by pid
+void Simulator::printspilled() {
+    std::ofstream report(config.outfile);
+    StatUpdater::printtitle(report, config.algorithm, config.timeq, spillsum.num_tasks);
+    StatUpdater::printheader(report);
+    ArrivalSorter bypid(spilled, config.spill, "", BY_PID);
+    PCB pcb;
+    bool first = true;
+    int last = 0;
+    while(bypid.next(pcb)){
+        // the reader skipped this check so it didn't have to keep every pid.
+        if(!first && pcb.pid == last){
+            report.close();
+            remove(config.outfile.c_str());
+            throw SimError("Can't have duplicate PIDs.");
+        }
+        first = false;
+        last = pcb.pid;
+        StatUpdater::printrow(report, &pcb);
+    }
+    StatUpdater::printsummary(report, spillsum);
+}
+
+void Simulator::run(PCBSource *src, const SimConfig &cfg, SimResults &results) {
+    begin(src, cfg, results);
+    while(step());
+    end(results);
+}
+
+SimSnapshot* Simulator::snapshot() {
+    SimSnapshot *snap = new SimSnapshot();
+    snap->engine = new SimEngine(*engine);
+    snap->ready_queue = ready_queue;
+    snap->blocked_queue = blocked_queue;
+    snap->finished = finished_queue.size();
+    snap->emitted = engine->pgen.getemitted();
+    snap->time = engine->clock.gettime();
+    return snap;
+}
+
+void Simulator::restore(const SimSnapshot *snap, PCBSource *src, const std::vector<PCB> &finished) {
+    *engine = *snap->engine;
+    engine->pgen.setsource(src);
+    ready_queue = snap->ready_queue;
+    blocked_queue = snap->blocked_queue;
+    // the copied scheduler's deadline heap still points into the queue that was just replaced.
+    engine->scheduler.reindex();
+    // keep whatever is still from the original run and bring back the rest.
+    int keep = std::min(snap->finished, unchanged);
+    while(finished_queue.size() > keep) finished_queue.remove_tail();
+    for(int index = keep; index < snap->finished; ++index) finished_queue.add_end(finished[index]);
+    unchanged = snap->finished;
+    lifeCycleVector.clear();
+    keeplifecycle = false;
+    // the report files belong to the run the snapshot came from.
+    config.outfile.clear();
+    sentfinished = engine->cpu.getcompleted();
+    published = sentfinished;
+    sentevents = 0;
+    recorded = 0;
+}
+
+float Simulator::gettime() {
+    return engine->clock.gettime();
+}
+
+SimResults Simulator::simulate(const std::vector<PCB> &workload, const SimConfig &cfg) {
+    SimResults results;
+    PCBValidator::check(workload);
+    WorkloadSource src(&workload);
+    run(&src, cfg, results);
+    return results;
+}
@@ -0,0 +1,46 @@
+#include "../headers/SpillFile.h"
+#include "../headers/SimError.h"
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+
+SpillFile::SpillFile(std::string dir) {
+    if(dir.empty()) dir = getenv("TMPDIR") != NULL ? getenv("TMPDIR") : "/tmp";
+    std::string name = dir + "/schedsim-spill-XXXXXX";
+    std::vector<char> buffer(name.begin(), name.end());
+    buffer.push_back('\0');
+    int fd = mkstemp(&buffer[0]);
+    if(fd < 0) throw SimError("Can't create a temporary file in " + dir + ".");
+    close(fd);
+    path = &buffer[0];
+    out.open(path.c_str(), std::ios::binary);
+    reading = false;
+    count = 0;
+}
+
+SpillFile::~SpillFile() {
+    out.close();
+    in.close();
+    remove(path.c_str());
+}
+
+void SpillFile::write(const PCB &pcb) {
+    out.write((const char*)&pcb, sizeof(pcb));
+    if(!out) throw SimError("Can't write temporary file " + path + ".");
+    count++;
+}
+
+bool SpillFile::next(PCB &pcb) {
+    if(!reading){
+        reading = true;
+        out.close();
+        if(!out) throw SimError("Can't write temporary file " + path + ".");
+        in.open(path.c_str(), std::ios::binary);
+    }
+    return bool(in.read((char*)&pcb, sizeof(pcb)));
+}
+
+size_t SpillFile::size() {
+    return count;
+}
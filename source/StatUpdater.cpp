@@ -3,8 +3,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <algorithm>
+#include <cmath>
+#include <sstream>
 
-StatUpdater::StatUpdater(DList<PCB> *rq, DList<PCB> *fq, Clock *cl, int alg, std::string fn, int tq, std::vector<PCBStatus> *vec){
+StatUpdater::StatUpdater(DList<PCB> *rq, DList<PCB> *fq, Clock *cl, int alg, std::string fn, int tq, StatusVector *vec){
     ready_queue = rq;
     finished_queue = fq;
     clock = cl;
@@ -13,6 +15,15 @@ StatUpdater::StatUpdater(DList<PCB> *rq, DList<PCB> *fq, Clock *cl, int alg, std
     filename = fn;
     last_update = 0;
     lcVector = vec;
+    stream = NULL;
+    reported = 0;
+    level_time = NULL;
+    group_usage = NULL;
+}
+
+void StatUpdater::setstream(std::ostream *os) {
+    stream = os;
+    if(stream != NULL) printheader(*stream);
 }
 
 //main function that gets called every clock cycle to update times of pcbs
@@ -26,78 +37,261 @@ void StatUpdater::execute() {
         PCB* temp = ready_queue->getindex(index);
         temp->wait_time += increment;
     }
+
+    //emit rows for anything the cpu finished since the last cycle, flushing so a reader on the other end sees them
+    if(stream != NULL && reported < finished_queue->size()){
+        while(reported < finished_queue->size()) printrow(*stream, finished_queue->getindex(reported++));
+        stream->flush();
+    }
+}
+
+void StatUpdater::setleveltime(const std::vector<float> *time) {
+    level_time = time;
+}
+
+void StatUpdater::setgroupusage(const std::vector<GroupStats> *usage) {
+    group_usage = usage;
+}
+
+void StatUpdater::printtitle(std::ostream &out, int alg, int timeq, int num_tasks) {
+    out << "*******************************************************************" << std::endl;
+    out << "Scheduling Algorithm: " << algorithmname(alg) << std::endl;
+    if(timeq != -1) out << "(No. Of Tasks = " << num_tasks << " Quantum = " << timeq << ")" << std::endl;
+    out << "*******************************************************************" << std::endl;
+}
+
+void StatUpdater::printheader(std::ostream &out) {
+    int colwidth = 11;
+    out << "----------------------------------------------------------------------------------------------------------------------" << std::endl;
+    out << "| " << std::left << std::setw(colwidth) << "PID" << "| " << std::left << std::setw(colwidth) << "Arrival"
+        << "| " << std::left << std::setw(colwidth) << "CPU-Burst" << "| " << std::left << std::setw(colwidth) << "Priority"
+        << "| " << std::left << std::setw(colwidth) << "Finish" << "| " << std::left << std::setw(colwidth) << "Waiting"
+        << "| " << std::left << std::setw(colwidth) << "Turnaround" << "| " << std::left << std::setw(colwidth) << "Response"
+        << "| " << std::left << std::setw(colwidth) << "C. Switches" << "| " << std::endl
+        << "----------------------------------------------------------------------------------------------------------------------" << std::endl;
+}
+
+void StatUpdater::printrow(std::ostream &out, const PCB *temp) {
+    int colwidth = 11;
+    float turnaround = temp->finish_time - temp->arrival;
+    out << "| " << std::left << std::setw(colwidth) << temp->pid << "| " << std::left << std::setw(colwidth)
+        << temp->arrival << "| " << std::left << std::setw(colwidth) << temp->burst << "| " << std::left
+        << std::setw(colwidth) << temp->priority << "| " << std::left << std::setw(colwidth) << temp->finish_time
+        << "| " << std::left << std::setw(colwidth) << temp->wait_time << "| " << std::left << std::setw(colwidth)
+        << turnaround << "| " << std::left << std::setw(colwidth) << temp->resp_time << "| " << std::left << std::setw(colwidth)
+        << temp->num_context << "|" << std::endl;
+    out << "----------------------------------------------------------------------------------------------------------------------" << std::endl;
+}
+
+
+std::string StatUpdater::algorithmname(int alg) {
+    switch(alg){
+        case 0:
+            return "FCFS";
+        case 1:
+            return "SRTF";
+        case 2:
+            return "Round Robin";
+        case 3:
+            return "Preemptive Priority";
+        case 4:
+            return "Preemptive Random";
+        case 5:
+            return "Earliest Deadline First";
+        case 6:
+            return "Multi-Level Feedback Queue";
+        case 7:
+            return "Group Fair Share";
+    }
+    return "";
 }
 
+//same totals print() reports, kept in memory for callers that run many simulations
+SimSummary StatUpdater::summarize(const std::vector<PCB> &finished) {
+    SimSummary sum;
+    sum.num_tasks = finished.size();
+    sum.contexts = 0;
+    sum.avg_burst = sum.avg_wait = sum.avg_turn = sum.avg_resp = sum.finish_time = 0;
+    std::vector<float> lateness;
+    for(size_t index = 0; index < finished.size(); ++index){
+        const PCB *temp = &finished[index];
+        if(temp->deadline >= 0) lateness.push_back(temp->finish_time - temp->deadline);
+        sum.avg_burst += temp->burst;
+        sum.avg_wait += temp->wait_time;
+        sum.avg_turn += temp->finish_time - temp->arrival;
+        sum.avg_resp += temp->resp_time;
+        sum.contexts += temp->num_context;
+        if(temp->finish_time > sum.finish_time) sum.finish_time = temp->finish_time;
+    }
+    if(sum.num_tasks > 0){
+        sum.avg_burst /= sum.num_tasks;
+        sum.avg_wait /= sum.num_tasks;
+        sum.avg_turn /= sum.num_tasks;
+        sum.avg_resp /= sum.num_tasks;
+    }
+    summarizedeadlines(sum, lateness);
+    return sum;
+}
+
+void StatUpdater::summarizedeadlines(SimSummary &sum, std::vector<float> &lateness) {
+    sum.deadlines = lateness.size();
+    sum.misses = 0;
+    sum.late_p50 = sum.late_p90 = sum.late_p99 = sum.late_max = 0;
+    if(lateness.empty()) return;
+    std::sort(lateness.begin(), lateness.end());
+    //finishing exactly at the deadline still makes it
+    sum.misses = lateness.end() - std::upper_bound(lateness.begin(), lateness.end(), 0.0f);
+    sum.late_p50 = lateness[size_t(std::ceil(0.50 * lateness.size())) - 1];
+    sum.late_p90 = lateness[size_t(std::ceil(0.90 * lateness.size())) - 1];
+    sum.late_p99 = lateness[size_t(std::ceil(0.99 * lateness.size())) - 1];
+    sum.late_max = lateness.back();
+}
+
+void StatUpdater::countlevel(SimSummary &sum, const PCB &pcb) {
+    if(pcb.level >= int(sum.level_finished.size())) sum.level_finished.resize(pcb.level + 1, 0);
+    sum.level_finished[pcb.level]++;
+}
+
+void StatUpdater::countgroup(SimSummary &sum, const PCB &pcb) {
+    GroupStats &group = sum.groups[pcb.group];
+    group.group = pcb.group;
+    group.finished++;
+    group.wait += pcb.wait_time;
+    group.turn += pcb.finish_time - pcb.arrival;
+    group.resp += pcb.resp_time;
+}
+
+void StatUpdater::addgroupusage(SimSummary &sum, const std::vector<GroupStats> &usage) {
+    for(size_t index = 0; index < usage.size(); ++index){
+        GroupStats &group = sum.groups[usage[index].group];
+        group.group = usage[index].group;
+        group.share = usage[index].share;
+        group.cpu_time = usage[index].cpu_time;
+        group.throttled_time = usage[index].throttled_time;
+        group.throttles = usage[index].throttles;
+    }
+}
+
+static bool comparePids(const PCB *a, const PCB *b) {
+    return a->pid < b->pid;
+}
 
 //straightforward print function that prints to file using iomanip and column for a table format
 //uses finished queue to tally up final stats
 void StatUpdater::print() {
+    std::ofstream outfile(filename);
+    print(outfile);
+}
+
+void StatUpdater::print(std::ostream &outfile) {
     num_tasks = finished_queue->size();
-    std::string alg;
-    int colwidth = 11;
     float tot_burst, tot_turn, tot_wait, tot_resp;
     int contexts;
     tot_burst = tot_turn = tot_wait = tot_resp = contexts = 0;
 
-    std::ofstream outfile(filename);
+    printtitle(outfile, algorithm, timeq, num_tasks);
+    printheader(outfile);
 
+    //rows go out in pid order, whatever the pids are
+    std::vector<PCB*> rows(num_tasks);
+    for(int index = 0; index < num_tasks; ++index) rows[index] = finished_queue->getindex(index);
+    std::sort(rows.begin(), rows.end(), comparePids);
+    std::vector<float> lateness;
+    float finish_time = 0;
+    for(int index = 0; index < num_tasks; ++index){
+        PCB *temp = rows[index];
+        if(temp->finish_time > finish_time) finish_time = temp->finish_time;
+        if(temp->deadline >= 0) lateness.push_back(temp->finish_time - temp->deadline);
+        float turnaround = temp->finish_time - temp->arrival;
+        tot_burst += temp->burst;
+        tot_turn += turnaround;
+        tot_wait += temp->wait_time;
+        tot_resp += temp->resp_time;
+        contexts += temp->num_context;
 
-    switch(algorithm){
-        case 0:
-            alg = "FCFS";
-            break;
-        case 1:
-            alg = "SRTF";
-            break;
-        case 2:
-            alg = "Round Robin";
-            break;
-        case 3:
-            alg = "Preemptive Priority";
-            break;
-        case 4:
-            alg = "Preemptive Random";
-            break;
+        printrow(outfile, temp);
+    }
+    SimSummary sum;
+    sum.num_tasks = num_tasks;
+    sum.contexts = contexts;
+    sum.avg_burst = tot_burst/num_tasks;
+    sum.avg_wait = tot_wait/num_tasks;
+    sum.avg_turn = tot_turn/num_tasks;
+    sum.avg_resp = tot_resp/num_tasks;
+    sum.finish_time = finish_time;
+    summarizedeadlines(sum, lateness);
+    if(level_time != NULL){
+        sum.level_time = *level_time;
+        for(int index = 0; index < num_tasks; ++index) countlevel(sum, *rows[index]);
+    }
+    if(group_usage != NULL){
+        addgroupusage(sum, *group_usage);
+        for(int index = 0; index < num_tasks; ++index) countgroup(sum, *rows[index]);
     }
+    printsummary(outfile, sum);
+}
 
-    outfile << "*******************************************************************" << std::endl;
-    outfile << "Scheduling Algorithm: " << alg << std::endl;
-    if(timeq != -1) outfile << "(No. Of Tasks = " << finished_queue->size() << " Quantum = " << timeq << ")" << std::endl;
-    outfile << "*******************************************************************" << std::endl;
-
-    outfile << "----------------------------------------------------------------------------------------------------------------------" << std::endl;
-    outfile << "| " << std::left << std::setw(colwidth) << "PID" << "| " << std::left << std::setw(colwidth) << "Arrival"
-            << "| " << std::left << std::setw(colwidth) << "CPU-Burst" << "| " << std::left << std::setw(colwidth) << "Priority"
-            << "| " << std::left << std::setw(colwidth) << "Finish" << "| " << std::left << std::setw(colwidth) << "Waiting"
-            << "| " << std::left << std::setw(colwidth) << "Turnaround" << "| " << std::left << std::setw(colwidth) << "Response"
-            << "| " << std::left << std::setw(colwidth) << "C. Switches" << "| " << std::endl
-            << "----------------------------------------------------------------------------------------------------------------------" << std::endl;
-
-    for(int id = 1; id < num_tasks+1; ++id){
-        for(int index = 0; index < finished_queue->size(); ++index){
-            if(finished_queue->getindex(index)->pid == id){
-                PCB *temp = finished_queue->getindex(index);
-                float turnaround = temp->finish_time - temp->arrival;
-                tot_burst += temp->burst;
-                tot_turn += turnaround;
-                tot_wait += temp->wait_time;
-                tot_resp += temp->resp_time;
-                contexts += temp->num_context;
-
-                outfile << "| " << std::left << std::setw(colwidth) << temp->pid << "| " << std::left << std::setw(colwidth)
-                        << temp->arrival << "| " << std::left << std::setw(colwidth) << temp->burst << "| " << std::left
-                        << std::setw(colwidth) << temp->priority << "| " << std::left << std::setw(colwidth) << temp->finish_time
-                        << "| " << std::left << std::setw(colwidth) << temp->wait_time << "| " << std::left << std::setw(colwidth)
-                        << turnaround << "| " << std::left << std::setw(colwidth) << temp->resp_time << "| " << std::left << std::setw(colwidth)
-                        << temp->num_context << "|" << std::endl;
-                outfile << "----------------------------------------------------------------------------------------------------------------------" << std::endl;
+void StatUpdater::printsummary(std::ostream &outfile, const SimSummary &sum) {
+    outfile << std::endl;
+    outfile << "Average CPU Burst Time: " << sum.avg_burst << " ms\t\tAverage Waiting Time: " << sum.avg_wait << " ms" << std::endl
+            << "Average Turnaround Time: " << sum.avg_turn << " ms\t\tAverage Response Time: " << sum.avg_resp << " ms" << std::endl
+            << "Total No. of Context Switching Performed: " << sum.contexts << std::endl;
+    // workloads without deadlines get the same report as before.
+    if(sum.deadlines > 0){
+        outfile << "Deadline Misses: " << sum.misses << " of " << sum.deadlines << " (Miss Ratio: "
+                << float(sum.misses) / sum.deadlines << ")" << std::endl
+                << "Lateness: p50 " << sum.late_p50 << " ms\t\tp90 " << sum.late_p90 << " ms\t\tp99 " << sum.late_p99
+                << " ms\t\tMax " << sum.late_max << " ms" << std::endl;
+    }
+    if(!sum.level_time.empty()){
+        int colwidth = 11;
+        float total = 0;
+        for(size_t level = 0; level < sum.level_time.size(); ++level) total += sum.level_time[level];
+        outfile << std::endl << "Time Per Level:" << std::endl;
+        outfile << "------------------------------------------------------" << std::endl;
+        outfile << "| " << std::left << std::setw(colwidth) << "Level" << "| " << std::left << std::setw(colwidth) << "CPU Time"
+                << "| " << std::left << std::setw(colwidth) << "Share" << "| " << std::left << std::setw(colwidth) << "Finished" << "| " << std::endl;
+        outfile << "------------------------------------------------------" << std::endl;
+        size_t count = std::max(sum.level_time.size(), sum.level_finished.size());
+        for(size_t level = 0; level < count; ++level){
+            float time = level < sum.level_time.size() ? sum.level_time[level] : 0;
+            int finished = level < sum.level_finished.size() ? sum.level_finished[level] : 0;
+            outfile << "| " << std::left << std::setw(colwidth) << level << "| " << std::left << std::setw(colwidth) << time
+                    << "| " << std::left << std::setw(colwidth) << (total > 0 ? time / total : 0) << "| " << std::left
+                    << std::setw(colwidth) << finished << "| " << std::endl;
+            outfile << "------------------------------------------------------" << std::endl;
+        }
+    }
+    if(!sum.groups.empty()){
+        int colwidth = 11;
+        std::string line(132, '-');
+        outfile << std::endl << "Per Group (Throughput is processes finished per 1000 ms, Waiting, Turnaround and Response are averages):" << std::endl;
+        outfile << line << std::endl;
+        outfile << "| " << std::left << std::setw(colwidth) << "Group" << "| " << std::left << std::setw(colwidth) << "Shares"
+                << "| " << std::left << std::setw(colwidth) << "Quota" << "| " << std::left << std::setw(colwidth) << "Finished"
+                << "| " << std::left << std::setw(colwidth) << "Throughput" << "| " << std::left << std::setw(colwidth) << "CPU Time"
+                << "| " << std::left << std::setw(colwidth) << "Throttled" << "| " << std::left << std::setw(colwidth) << "Waiting"
+                << "| " << std::left << std::setw(colwidth) << "Turnaround" << "| " << std::left << std::setw(colwidth) << "Response" << "| " << std::endl;
+        outfile << line << std::endl;
+        for(std::map<int, GroupStats>::const_iterator it = sum.groups.begin(); it != sum.groups.end(); ++it){
+            const GroupStats &group = it->second;
+            // quota/period the way cpu.max writes it, max when there is no limit.
+            std::string quota = "max";
+            if(group.share.quota > 0){
+                std::stringstream text;
+                text << group.share.quota << "/" << group.share.period;
+                quota = text.str();
             }
+            int count = std::max(group.finished, 1);
+            outfile << "| " << std::left << std::setw(colwidth) << it->first << "| " << std::left << std::setw(colwidth) << group.share.shares
+                    << "| " << std::left << std::setw(colwidth) << quota << "| " << std::left << std::setw(colwidth) << group.finished
+                    << "| " << std::left << std::setw(colwidth) << (sum.finish_time > 0 ? group.finished * 1000 / sum.finish_time : 0)
+                    << "| " << std::left << std::setw(colwidth) << group.cpu_time << "| " << std::left << std::setw(colwidth) << group.throttled_time
+                    << "| " << std::left << std::setw(colwidth) << float(group.wait / count) << "| " << std::left << std::setw(colwidth) << float(group.turn / count)
+                    << "| " << std::left << std::setw(colwidth) << float(group.resp / count) << "| " << std::endl;
+            outfile << line << std::endl;
         }
     }
-    outfile << std::endl;
-    outfile << "Average CPU Burst Time: " << tot_burst/num_tasks << " ms\t\tAverage Waiting Time: " << tot_wait/num_tasks << " ms" << std::endl
-            << "Average Turnaround Time: " << tot_turn/num_tasks << " ms\t\tAverage Response Time: " << tot_resp/num_tasks << " ms" << std::endl
-            << "Total No. of Context Switching Performed: " << contexts << std::endl;
 }
 
 int mapStateToColumn(PROCESS_STATE state) {
@@ -123,78 +317,62 @@ int mapStateToColumn(PROCESS_STATE state) {
     return columnIx;
 }
 
-bool compareCpuTimes(PCBStatus& obj1, PCBStatus& obj2) {
-    return obj1.getRecordedCpuTime() < obj2.getRecordedCpuTime();
-}
-
 /*
-A method to print the lifecycle of a process through multiple stages. Prints a 2D matrix with nrows = (timer * 2)+1
-and ncols = 5 (Created, Ready, Running, Blocked, Completed). Uses the vector<PCBStatus> data structure to
+A method to print the lifecycle of a process through multiple stages. Prints a table with a row for every half ms
+something happened in and ncols = 5 (Created, Ready, Running, Blocked, Completed). Uses the vector<PCBStatus> data structure to
 access the times and state transitions.
 A sample of how this list looks:
 Px = [(CREATED, t, pid), (READY, t, pid), (RUNNING, t, pid), (BLOCKED, t, pid), (READY, t, pid), 
     (RUNNING, t, pid), (COMPLETED, t, pid)]
 */
 void StatUpdater::printProcessLifecycle() {
+    // Our output file will simply be the output file name + lifecycle 
+    std::string lcfilenamae = filename+"-lifecycle";
+    std::ofstream outfile2(lcfilenamae);
+    printProcessLifecycle(outfile2);
+}
 
-    // sort the lifeCycle vector in ascending order of CPU time.
-    std::sort(lcVector->begin(), lcVector->end(), compareCpuTimes);
+void StatUpdater::printProcessLifecycle(std::ostream &outfile2) {
+    // nothing happened, nothing to print.
+    if(lcVector->empty()) return;
 
-    // determine the number of rows required.
-    int rows = int(lcVector->at(lcVector->size() - 1).getRecordedCpuTime() * 2) + 1;
-    // number of columns = number of states.
+    // the vector is already in order of CPU time, see Simulator::orderevents, so every row is filled in
+    // and printed before the next one starts. pids in a cell are in the order their transitions happened.
     int columns = 5;
+    typedef CountingAllocator<char, MEM_LIFECYCLE_PRINT> CellAllocator;
+    typedef std::basic_string<char, std::char_traits<char>, CellAllocator> TableCell;
+    std::vector<TableCell, CountingAllocator<TableCell, MEM_LIFECYCLE_PRINT> > cells(columns);
 
-    // Create a 2D matrix of strings
-    vector<vector<string>> matrix(rows, vector<string>(columns));
-
-    // Initialize the matrix with values
-    for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < columns; j++) {
-            matrix[i][j] = string("");
-        }
-    }
     // Taken from the code above.
     int colwidth = 11;
 
-    // Only print the lines which were affected.
-    int *rowmodified = (int*)calloc(rows,sizeof(int));
+    // // Now, time to beautify the output and append to the outputstream.
+    outfile2 << "-------------------------------------------------------------------------------" << std::endl;
+    outfile2 << "| " << std::left << std::setw(colwidth) << "CPU TIME" << "| " << std::left << std::setw(colwidth) << "CREATED" << "| " << std::left << std::setw(colwidth) << "READY"
+            << "| " << std::left << std::setw(colwidth) << "RUNNING" << "| " << std::left << std::setw(colwidth) << "BLOCKED"
+            << "| " << std::left << std::setw(colwidth) << "COMPLETED" << "| " << std::endl;
+    outfile2 << "-------------------------------------------------------------------------------" << std::endl;
 
     // iterate over every state captured in the state vector.
-    for (int ix=0; ix < lcVector->size(); ix++) {
-        PCBStatus status = lcVector->at(ix);
-        
+    for (size_t ix = 0; ix < lcVector->size(); ix++) {
+        PCBStatus &status = (*lcVector)[ix];
+
         // determine which row and column this will go to.
         int row = int(status.getRecordedCpuTime() * 2);
         int col = mapStateToColumn(status.getRecordedState());
 
         // If there's nothing at this cell, simply add the P<id>.
-        if (matrix[row][col] == "") {
-            rowmodified[row]=1;
-            matrix[row][col] = "P" + to_string(status.getPid());
-        } else {
-            // Otherwise, append the P<id> to the previous contents.
-            rowmodified[row]=1;
-            matrix[row][col] = matrix[row][col] + ", P" + to_string(status.getPid());
-        }
-    }
-    
-    // Our output file will simply be the output file name + lifecycle 
-    std::string lcfilenamae = filename+"-lifecycle";
-    std::ofstream outfile2(lcfilenamae);
+        // Otherwise, append the P<id> to the previous contents.
+        if (!cells[col].empty()) cells[col] += ", ";
+        cells[col] += ("P" + std::to_string(status.getPid())).c_str();
 
-    // // Now, time to beautify the output and append to the outputstream.
-    outfile2 << "-------------------------------------------------------------------------------" << std::endl;
-    outfile2 << "| " << std::left << std::setw(colwidth) << "CPU TIME" << "| " << std::left << std::setw(colwidth) << "CREATED" << "| " << std::left << std::setw(colwidth) << "READY"
-            << "| " << std::left << std::setw(colwidth) << "RUNNING" << "| " << std::left << std::setw(colwidth) << "BLOCKED"
-            << "| " << std::left << std::setw(colwidth) << "COMPLETED" << "| " << std::endl;
-    outfile2 << "-------------------------------------------------------------------------------" << std::endl;
-    for (int row = 0; row < rows; row++) {
-        if(!rowmodified[row]) continue;
-        outfile2 << "| " << std::left << std::setw(colwidth) << 0.5 * row << "| " << std::left << std::setw(colwidth) << matrix[row][0] << "| " << std::left << std::setw(colwidth)
-                << matrix[row][1] << "| " << std::left << std::setw(colwidth) << matrix[row][2] << "| " << std::left
-                << std::setw(colwidth) << matrix[row][3] << "| " << std::left << std::setw(colwidth) << matrix[row][4]
+        // Only print a row once the last transition in it is there.
+        if (ix + 1 < lcVector->size() && int((*lcVector)[ix + 1].getRecordedCpuTime() * 2) == row) continue;
+        outfile2 << "| " << std::left << std::setw(colwidth) << 0.5 * row << "| " << std::left << std::setw(colwidth) << cells[0] << "| " << std::left << std::setw(colwidth)
+                << cells[1] << "| " << std::left << std::setw(colwidth) << cells[2] << "| " << std::left
+                << std::setw(colwidth) << cells[3] << "| " << std::left << std::setw(colwidth) << cells[4]
                 << "| " << std::endl;
         outfile2 << "-------------------------------------------------------------------------------" << std::endl;
+        for (int j = 0; j < columns; j++) cells[j].clear();
     }
 }
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "../headers/Telemetry.h"
+
+Telemetry::Telemetry(DList<PCB> *rq, DList<PCB> *bq, CPU *cp, Dispatcher *disp, Clock *cl, float iv, TelemetrySeries *out, std::ostream *os) {
+    ready_queue = rq;
+    blocked_queue = bq;
+    cpu = cp;
+    dispatcher = disp;
+    clock = cl;
+    interval = iv;
+    next_sample = clock->gettime() + interval;
+    last_time = clock->gettime();
+    last_busy = cpu->getbusytime();
+    last_switches = dispatcher->getswitches();
+    last_completed = cpu->getcompleted();
+    series = out;
+    stream = os;
+    if(stream != NULL) printheader(*stream);
+}
+
+void Telemetry::execute() {
+    if(clock->gettime() >= next_sample) {
+        sample();
+        // a context switch can push the clock past more than one boundary, only sample once for it.
+        while(next_sample <= clock->gettime()) next_sample += interval;
+    }
+}
+
+void Telemetry::finish() {
+    if(clock->gettime() > last_time) sample();
+}
+
+void Telemetry::sample() {
+    float now = clock->gettime();
+    float busy = cpu->getbusytime() - last_busy;
+    int switches = dispatcher->getswitches() - last_switches;
+    int completed = cpu->getcompleted() - last_completed;
+
+    //flush streamed rows so whoever is tailing the file sees each window as soon as it closes
+    if(stream != NULL){
+        printrow(*stream, last_time, now, ready_queue->size(), blocked_queue->size(), busy, switches, completed);
+        stream->flush();
+    }
+    else {
+        series->time.push_back(now);
+        series->ready.push_back(ready_queue->size());
+        series->blocked.push_back(blocked_queue->size());
+        series->busy.push_back(busy);
+        series->switches.push_back(switches);
+        series->completed.push_back(completed);
+    }
+
+    last_time = now;
+    last_busy += busy;
+    last_switches += switches;
+    last_completed += completed;
+}
+
+void Telemetry::printheader(std::ostream &out) {
+    out << "time,ready,blocked,cpu_util,switches_per_ms,completed_per_ms" << std::endl;
+}
+
+void Telemetry::printrow(std::ostream &out, float start, float end, int ready, int blocked, float busy, int switches, int completed) {
+    float len = end - start;
+    out << end << "," << ready << "," << blocked << "," << busy / len << ","
+        << switches / len << "," << completed / len << "\n";
+}
+
+void Telemetry::print(std::ostream &out, const TelemetrySeries &series) {
+    printheader(out);
+    float start = 0;
+    for(size_t i = 0; i < series.size(); ++i){
+        printrow(out, start, series.time[i], series.ready[i], series.blocked[i], series.busy[i], series.switches[i], series.completed[i]);
+        start = series.time[i];
+    }
+}
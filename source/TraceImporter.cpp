@@ -0,0 +1,223 @@
+#include "../headers/TraceImporter.h"
+#include "../headers/SimError.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+TraceImporter::TraceImporter(std::string fn) {
+    filename = fn;
+    parsed = false;
+    first = last = -1;
+    events = 0;
+    position = 0;
+}
+
+//integer starting at p, stops at the first character that isn't a digit
+static long long number(const char *p) {
+    bool negative = *p == '-';
+    if(negative) p++;
+    long long n = 0;
+    while(*p >= '0' && *p <= '9') n = n * 10 + (*p++ - '0');
+    return negative ? -n : n;
+}
+
+//value of a key=value field, NULL if the line doesn't have it
+static const char* field(const char *from, const char *key) {
+    const char *p = strstr(from, key);
+    return p != NULL ? p + strlen(key) : NULL;
+}
+
+//pid of a compact "comm:pid [prio]" task, bracket points at the [
+static int compactpid(const char *bracket) {
+    const char *p = bracket - 1;
+    while(*(p - 1) >= '0' && *(p - 1) <= '9') p--;
+    return number(p);
+}
+
+TraceImporter::Task& TraceImporter::task(int pid, long long t) {
+    std::unordered_map<int, size_t>::iterator it = index.find(pid);
+    if(it != index.end()) return tasks[it->second];
+    index[pid] = tasks.size();
+    Task fresh;
+    fresh.arrival = t;
+    fresh.cpu = fresh.sleep = 0;
+    fresh.run_start = fresh.sleep_start = -1;
+    fresh.prio = 120;
+    tasks.push_back(fresh);
+    return tasks.back();
+}
+
+//picks the switch or wakeup out of one line of either perf or ftrace output, anything else is ignored
+void TraceImporter::parseline(char *line) {
+    bool isswitch = true;
+    const char *ev = strstr(line, "sched_switch: ");
+    if(ev == NULL){
+        isswitch = false;
+        ev = strstr(line, "sched_wakeup");
+        if(ev == NULL) return;
+        if(strncmp(ev + 12, ": ", 2) != 0 && strncmp(ev + 12, "_new: ", 6) != 0) return;
+    }
+
+    // the timestamp is the "seconds.fraction:" token in front of the event name.
+    const char *p = ev;
+    while(p > line && *(p - 1) != ' ') p--;
+    while(p > line && *(p - 1) == ' ') p--;
+    if(p == line || *(p - 1) != ':') return;
+    const char *end = --p;
+    while(p > line && ((*(p - 1) >= '0' && *(p - 1) <= '9') || *(p - 1) == '.')) p--;
+    if(p == end) return;
+    long long t = number(p) * 1000000000LL;
+    const char *dot = (const char*)memchr(p, '.', end - p);
+    if(dot != NULL){
+        long long scale = 100000000LL;
+        for(const char *d = dot + 1; d < end && scale > 0; ++d, scale /= 10) t += (*d - '0') * scale;
+    }
+
+    if(first < 0) first = t;
+    last = t;
+    events++;
+    const char *args = strchr(ev, ' ') + 1;
+
+    if(!isswitch){
+        const char *pid = field(args, "pid=");
+        const char *prio = field(args, " prio=");
+        const char *bracket = NULL;
+        if(pid == NULL){
+            // perf sched script's compact form, "comm:pid [prio] ..."
+            bracket = strstr(args, " [");
+            if(bracket == NULL) return;
+            bracket++;
+        }
+        int id = pid != NULL ? number(pid) : compactpid(bracket);
+        if(id == 0) return;
+        Task &woken = task(id, t);
+        if(prio != NULL) woken.prio = number(prio);
+        else if(bracket != NULL) woken.prio = number(bracket + 1);
+        if(woken.sleep_start >= 0){
+            woken.sleep += t - woken.sleep_start;
+            woken.sleep_start = -1;
+        }
+        return;
+    }
+
+    int prev, next, prevprio, nextprio;
+    char state;
+    const char *prevpid = field(args, "prev_pid=");
+    if(prevpid != NULL){
+        const char *nextpid = field(args, " next_pid=");
+        const char *pp = field(args, " prev_prio="), *np = field(args, " next_prio="), *st = field(args, " prev_state=");
+        if(nextpid == NULL || pp == NULL || np == NULL || st == NULL) return;
+        prev = number(prevpid);
+        next = number(nextpid);
+        prevprio = number(pp);
+        nextprio = number(np);
+        state = *st;
+    }
+    else {
+        // compact form, "comm:pid [prio] state ==> comm:pid [prio]"
+        const char *arrow = strstr(args, " ==> ");
+        if(arrow == NULL) return;
+        const char *lb = arrow;
+        while(lb > args && *lb != '[') lb--;
+        const char *rb = strrchr(arrow, '[');
+        const char *close = strchr(lb, ']');
+        if(*lb != '[' || rb == NULL || close == NULL || lb == args) return;
+        prev = compactpid(lb);
+        prevprio = number(lb + 1);
+        state = *(close + 2);
+        next = compactpid(rb);
+        nextprio = number(rb + 1);
+    }
+
+    if(prev != 0){
+        Task &out = task(prev, t);
+        out.prio = prevprio;
+        if(out.run_start >= 0){
+            out.cpu += t - out.run_start;
+            out.run_start = -1;
+        }
+        // preempted tasks (R) are still runnable, dead ones (X, Z) never wake up again.
+        if(state == 'S' || state == 'D' || state == 'I') out.sleep_start = t;
+    }
+    if(next != 0){
+        Task &in = task(next, t);
+        in.prio = nextprio;
+        // a wakeup that happened before the trace started or wasn't recorded.
+        if(in.sleep_start >= 0){
+            in.sleep += t - in.sleep_start;
+            in.sleep_start = -1;
+        }
+        in.run_start = t;
+    }
+}
+
+void TraceImporter::parse() {
+    parsed = true;
+    FILE *in = filename == "-" ? stdin : fopen(filename.c_str(), "r");
+    if(in == NULL) throw SimError("Can't open " + filename + ".");
+
+    // read in big blocks and cut lines in place, a line that straddles two blocks is moved to the front.
+    std::vector<char> buffer(1 << 20);
+    size_t have = 0;
+    while(true){
+        if(have == buffer.size() - 1) buffer.resize(buffer.size() * 2);
+        size_t got = fread(&buffer[have], 1, buffer.size() - 1 - have, in);
+        have += got;
+        buffer[have] = '\0';
+        char *start = &buffer[0];
+        char *newline;
+        while((newline = (char*)memchr(start, '\n', &buffer[have] - start)) != NULL){
+            *newline = '\0';
+            parseline(start);
+            start = newline + 1;
+        }
+        have = &buffer[have] - start;
+        memmove(&buffer[0], start, have);
+        if(got == 0){
+            // the last line doesn't need a newline.
+            buffer[have] = '\0';
+            if(have > 0) parseline(&buffer[0]);
+            break;
+        }
+    }
+    if(in != stdin) fclose(in);
+
+    // tasks still running when the trace ends only get the time up to its end.
+    for(size_t i = 0; i < tasks.size(); ++i){
+        if(tasks[i].run_start >= 0) tasks[i].cpu += last - tasks[i].run_start;
+    }
+    for(size_t i = 0; i < tasks.size(); ++i){
+        const Task &t = tasks[i];
+        if(t.cpu <= 0) continue;
+        int arrival = int((t.arrival - first) / 1000000);
+        int burst = std::max(1, int(std::round(t.cpu / 1e6)));
+        int priority = std::max(0, t.prio - 100);
+        int io = int(std::round(t.sleep / 1e6));
+        workload.push_back(PCB(workload.size() + 1, arrival, burst, priority, io));
+    }
+    // the per-task state isn't needed anymore, only the workload is kept.
+    std::unordered_map<int, size_t>().swap(index);
+    std::vector<Task>().swap(tasks);
+    if(workload.empty()) throw SimError("No task in " + filename + " ran on a cpu.");
+}
+
+bool TraceImporter::next(PCB &pcb) {
+    if(!parsed) parse();
+    if(position >= workload.size()) return false;
+    pcb = workload[position++];
+    return true;
+}
+
+void TraceImporter::write(std::ostream &out) {
+    if(!parsed) parse();
+    for(size_t i = 0; i < workload.size(); ++i){
+        const PCB &p = workload[i];
+        out << p.pid << " " << p.arrival << " " << p.burst << " " << p.priority << " " << p.io_burst << "\n";
+    }
+}
+
+size_t TraceImporter::getevents() {
+    return events;
+}
@@ -0,0 +1,125 @@
+#include "../headers/WhatIf.h"
+#include "../headers/PCBSource.h"
+#include "../headers/Phases.h"
+#include "../headers/StatUpdater.h"
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+#include <utility>
+
+WhatIf::WhatIf(const std::vector<PCB> *w, SimConfig cfg, float iv) {
+    workload = w;
+    config = cfg;
+    interval = iv;
+}
+
+WhatIf::~WhatIf() {
+    for(size_t i = 0; i < snapshots.size(); ++i) delete snapshots[i];
+}
+
+void WhatIf::run() {
+    WorkloadSource src(workload);
+    sim.begin(&src, config, baseline);
+    // nothing has arrived yet at time 0, so any change can resume from here.
+    snapshots.push_back(sim.snapshot());
+    float next = interval;
+    while(sim.step()){
+        if(sim.gettime() >= next){
+            snapshots.push_back(sim.snapshot());
+            next += interval;
+        }
+    }
+    sim.end(baseline);
+}
+
+size_t WhatIf::divergence(const std::vector<PCB> &a, const std::vector<PCB> &b) {
+    size_t index = 0;
+    for(; index < a.size() && index < b.size(); ++index){
+        if(a[index].pid != b[index].pid || a[index].arrival != b[index].arrival || a[index].burst != b[index].burst
+           || a[index].priority != b[index].priority || a[index].io_burst != b[index].io_burst
+           || a[index].deadline != b[index].deadline || a[index].group != b[index].group
+           || !Phases::same(a[index], b[index])) break;
+    }
+    return index;
+}
+
+float WhatIf::compare(const std::vector<PCB> &changed, SimResults &results) {
+    size_t first = divergence(*workload, changed);
+    //a snapshot works as long as every process it had taken in is unchanged, and the first changed one
+    //wouldn't have been taken in by then either. both only get harder to meet as time goes on.
+    size_t pick = 0;
+    for(size_t i = snapshots.size(); i-- > 0;){
+        const SimSnapshot *snap = snapshots[i];
+        if(size_t(snap->emitted) > first) continue;
+        if(size_t(snap->emitted) == first && first < changed.size() && changed[first].arrival < snap->time) continue;
+        pick = i;
+        break;
+    }
+    WorkloadSource src(&changed, snapshots[pick]->emitted);
+    sim.restore(snapshots[pick], &src, baseline.finished);
+    while(sim.step());
+    sim.end(results);
+    return snapshots[pick]->time;
+}
+
+void WhatIf::print(std::string filename, const SimResults &results, float resumed) {
+    // line processes up by pid, rows come out in baseline finishing order followed by added processes.
+    std::unordered_map<int, const PCB*> after;
+    for(size_t i = 0; i < results.finished.size(); ++i) after[results.finished[i].pid] = &results.finished[i];
+    std::vector<std::pair<const PCB*, const PCB*> > rows;
+    for(size_t i = 0; i < baseline.finished.size(); ++i){
+        const PCB *b = &baseline.finished[i];
+        std::unordered_map<int, const PCB*>::iterator it = after.find(b->pid);
+        if(it == after.end()) rows.push_back(std::make_pair(b, (const PCB*)NULL));
+        else {
+            rows.push_back(std::make_pair(b, it->second));
+            after.erase(it);
+        }
+    }
+    for(size_t i = 0; i < results.finished.size(); ++i)
+        if(after.count(results.finished[i].pid)) rows.push_back(std::make_pair((const PCB*)NULL, &results.finished[i]));
+
+    int colwidth = 11;
+    std::ofstream outfile(filename);
+    outfile << "*******************************************************************" << std::endl;
+    outfile << "Scheduling Algorithm: " << StatUpdater::algorithmname(config.algorithm) << std::endl;
+    outfile << "(What-If Resumed At " << resumed << " ms of " << baseline.summary.finish_time << " ms)" << std::endl;
+    outfile << "*******************************************************************" << std::endl;
+    outfile << "------------------------------------------------------------------------------------" << std::endl;
+    outfile << "| " << std::left << std::setw(colwidth) << "PID" << "| " << std::left << std::setw(colwidth) << "Finish"
+            << "| " << std::left << std::setw(colwidth) << "Waiting" << "| " << std::left << std::setw(colwidth) << "Turnaround"
+            << "| " << std::left << std::setw(colwidth) << "Response" << "| " << std::left << std::setw(colwidth) << "C. Switches"
+            << "| " << std::endl;
+    outfile << "------------------------------------------------------------------------------------" << std::endl;
+    int differ = 0;
+    for(size_t row = 0; row < rows.size(); ++row){
+        const PCB *b = rows[row].first, *a = rows[row].second;
+        if(b != NULL && a != NULL && b->finish_time == a->finish_time && b->wait_time == a->wait_time
+           && b->resp_time == a->resp_time && b->num_context == a->num_context && b->arrival == a->arrival) continue;
+        differ++;
+        outfile << "| " << std::left << std::setw(colwidth) << (b != NULL ? b->pid : a->pid);
+        if(b == NULL || a == NULL){
+            // the process was added or removed, there is nothing to take a difference against.
+            std::string what = b == NULL ? "added" : "removed";
+            for(int col = 0; col < 5; ++col) outfile << "| " << std::left << std::setw(colwidth) << what;
+        }
+        else {
+            outfile << "| " << std::left << std::setw(colwidth) << std::showpos << a->finish_time - b->finish_time
+                    << "| " << std::left << std::setw(colwidth) << a->wait_time - b->wait_time
+                    << "| " << std::left << std::setw(colwidth) << (a->finish_time - a->arrival) - (b->finish_time - b->arrival)
+                    << "| " << std::left << std::setw(colwidth) << a->resp_time - b->resp_time
+                    << "| " << std::left << std::setw(colwidth) << a->num_context - b->num_context << std::noshowpos;
+        }
+        outfile << "| " << std::endl;
+        outfile << "------------------------------------------------------------------------------------" << std::endl;
+    }
+
+    const SimSummary &b = baseline.summary, &a = results.summary;
+    outfile << std::endl;
+    outfile << "Processes Changed: " << differ << " of " << results.finished.size() << std::endl;
+    outfile << "Average Waiting Time: " << b.avg_wait << " -> " << a.avg_wait << " ms\t\tAverage Turnaround Time: "
+            << b.avg_turn << " -> " << a.avg_turn << " ms" << std::endl
+            << "Average Response Time: " << b.avg_resp << " -> " << a.avg_resp << " ms\t\tFinish Time: "
+            << b.finish_time << " -> " << a.finish_time << " ms" << std::endl
+            << "Total No. of Context Switching Performed: " << b.contexts << " -> " << a.contexts << std::endl;
+}
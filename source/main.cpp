@@ -1,116 +1,380 @@
 #include <iostream>
 #include <stdlib.h>
-#include "../headers/Clock.h"
-#include "../headers/PCBGenerator.h"
-#include "../headers/CPU.h"
-#include "../headers/StatUpdater.h"
-#include "../headers/PCBStatus.h"
+#include "../headers/SchedSim.h"
 #include <time.h>
+#include <fstream>
+#include <sstream>
+#include <string>
 #include <vector>
 
 using namespace std;
 
-// Placeholder function to manage blocked queue.
-void serveIO(DList<PCB> *rq, DList<PCB> *bq, Clock *clock, std::vector<PCBStatus> *stateVec) {
-
-    // Only perform ops if the blocked queue is valid and has any elements at all.
-    if (bq != nullptr && bq->size()) {
-
-        // this loop will ONLY look at processes with io_burst <= 0 and move them to the ready queue.
-        for (int i=0; i < bq->size(); ++i) {
-            if (bq->getindex(i)->io_burst <= 0) {
-                
-                // Capture the state transition.
-                PCBStatus status(PROCESS_STATE::IN_READY_QUEUE, clock->gettime(), bq->getindex(i)->pid);
-                stateVec->push_back(status);
-                // move this process to the ready queue.
-                rq->add_end(*bq->getindex(i));
-                bq->removeindex(i);
-
-                // decrement i by one to account for the deletion of a node.
-                i--;
+int main(int argc, char* argv[]) {
+
+    //separate the optional --flags from the positional arguments
+    std::vector<char*> args;
+    bool stream = false;
+    bool seeded = false;
+    unsigned seed = 0;
+    int ensemble = 0;
+    float telemetry = 0;
+    bool telemetry_stream = false;
+    bool pipeline = false;
+    std::string cachedir;
+    int objective = -1;
+    int qmax = 0;
+    std::vector<std::string> whatifs;
+    float snapshot_every = 1000;
+    bool unsorted = false;
+    float sort_memory = 256;
+    bool trace = false;
+    bool gantt = false;
+    bool memory = false;
+    bool spill = false;
+    std::vector<float> levels;
+    float boost = 1000;
+    std::string trace_export;
+    int validate = 0;
+    bool batch = false;
+    int cluster = 0;
+    int placement = PLACE_LEAST_LOADED;
+    float window = 1;
+    std::string progress_socket;
+    std::string groupfile;
+    for(int i = 0; i < argc; ++i){
+        std::string arg = argv[i];
+        if(arg == "--stream") stream = true;
+        else if(arg == "--seed" && i+1 < argc){
+            seeded = true;
+            seed = strtoul(argv[++i], NULL, 10);
+        }
+        else if(arg == "--ensemble" && i+1 < argc) ensemble = atoi(argv[++i]);
+        else if(arg == "--telemetry" && i+1 < argc) telemetry = atof(argv[++i]);
+        else if(arg == "--telemetry-stream") telemetry_stream = true;
+        else if(arg == "--pipeline") pipeline = true;
+        else if(arg == "--cache" && i+1 < argc) cachedir = argv[++i];
+        else if(arg == "--optimize" && i+1 < argc){
+            objective = QuantumOptimizer::parseobjective(argv[++i]);
+            if(objective < 0){
+                cout << "--optimize takes one of: wait, turnaround, p99, response, switches" << endl;
+                return EXIT_FAILURE;
             }
         }
-
-        // This loop will go over every process in the blocked queue and decrement their IO time by 0.5.
-        for (int i=0; i<bq->size(); ++i) {
-            // Decrement all the burst times by 0.5.
-            bq->getindex(i)->io_burst -= 0.5;
+        else if(arg == "--qmax" && i+1 < argc) qmax = atoi(argv[++i]);
+        else if(arg == "--whatif" && i+1 < argc) whatifs.push_back(argv[++i]);
+        else if(arg == "--snapshot-every" && i+1 < argc) snapshot_every = atof(argv[++i]);
+        else if(arg == "--unsorted") unsorted = true;
+        else if(arg == "--sort-memory" && i+1 < argc) sort_memory = atof(argv[++i]);
+        else if(arg == "--trace") trace = true;
+        else if(arg == "--gantt") gantt = true;
+        else if(arg == "--memory") memory = true;
+        else if(arg == "--spill") spill = true;
+        else if(arg == "--levels" && i+1 < argc){
+            // comma separated quanta, one per level, highest level first.
+            std::stringstream list(argv[++i]);
+            std::string quantum;
+            while(std::getline(list, quantum, ',')) levels.push_back(atof(quantum.c_str()));
+        }
+        else if(arg == "--boost" && i+1 < argc) boost = atof(argv[++i]);
+        else if(arg == "--trace-export" && i+1 < argc) trace_export = argv[++i];
+        else if(arg == "--validate" && i+1 < argc) validate = atoi(argv[++i]);
+        else if(arg == "--batch") batch = true;
+        else if(arg == "--cluster" && i+1 < argc) cluster = atoi(argv[++i]);
+        else if(arg == "--placement" && i+1 < argc){
+            placement = Cluster::parseplacement(argv[++i]);
+            if(placement < 0){
+                cout << "--placement takes one of: rr, least, p2c" << endl;
+                return EXIT_FAILURE;
+            }
         }
+        else if(arg == "--window" && i+1 < argc) window = atof(argv[++i]);
+        else if(arg == "--progress-socket" && i+1 < argc) progress_socket = argv[++i];
+        else if(arg == "--groups" && i+1 < argc) groupfile = argv[++i];
+        else args.push_back(argv[i]);
     }
-}
 
-int main(int argc, char* argv[]) {
+    // compares the other engines with the plain clock loop on random workloads, the only argument
+    // it takes is where to write a workload that shows a difference.
+    if(validate > 0){
+        unsigned checkseed = seeded ? seed : time(NULL);
+        cout << "Validating with --seed " << checkseed << endl;
+        EquivalenceCheck check(checkseed);
+        return check.run(validate, cout, args.size() > 1 ? args[1] : "validate-reproducer.txt") ? 0 : EXIT_FAILURE;
+    }
 
     //initial args validation
-    if(argc < 4){
+    if(args.size() < 4){
         cout << "Not enough arguments sent to main." << endl;
-        cout << "Format should be: ./lab2 inputfile outputfile algorithm timequantum(if algorithm == 2)" << endl;
+        cout << "Format should be: ./lab2 inputfile outputfile algorithm timequantum(if algorithm is 2, 3, 4 or 7) [--stream] [--seed n] [--ensemble k] [--telemetry ms [--telemetry-stream]] [--pipeline] [--cache dir] [--optimize objective [--qmax n]] [--whatif file [--snapshot-every ms]] [--unsorted [--sort-memory MB]] [--trace [--trace-export file]] [--gantt] [--memory] [--spill [--sort-memory MB]] [--levels q0,q1,... [--boost ms]] [--batch] [--cluster n [--placement rr|least|p2c] [--window ms]] [--progress-socket path] [--groups file]" << endl;
+        cout << "Or: ./lab2 [reproducerfile] --validate n [--seed n]" << endl;
+        cout << "Use - as the inputfile to read processes from stdin" << endl;
         return EXIT_FAILURE;
     }
-    if(atoi(argv[3]) == 2 && argc == 4){
+    if(atoi(args[3]) == 2 && args.size() == 4 && objective < 0){
         cout << "Need to provide time quantum when using Round Robin algorithm" << endl;
         return EXIT_FAILURE;
     }
+    if((atoi(args[3]) == 3 || atoi(args[3]) == 4) && args.size() == 4 && objective < 0){
+        cout << "Need to provide time quantum when using Preemptive Priority or Preemptive Random algorithm" << endl;
+        return EXIT_FAILURE;
+    }
+    if(atoi(args[3]) == 7 && args.size() == 4){
+        cout << "Need to provide time quantum when using Group Fair Share algorithm" << endl;
+        return EXIT_FAILURE;
+    }
+    if(!groupfile.empty() && atoi(args[3]) != 7){
+        cout << "--groups only applies to Group Fair Share (7)" << endl;
+        return EXIT_FAILURE;
+    }
+    if(atoi(args[3]) == 6 && args.size() == 4 && levels.empty()){
+        cout << "Need to provide time quantum or --levels when using Multi-Level Feedback Queue algorithm" << endl;
+        return EXIT_FAILURE;
+    }
+    if(levels.size() > 64 || boost < 0){
+        cout << "--levels takes at most 64 quanta and --boost can't be negative" << endl;
+        return EXIT_FAILURE;
+    }
+    if(telemetry < 0){
+        cout << "--telemetry needs a positive sampling interval in ms" << endl;
+        return EXIT_FAILURE;
+    }
+    if(ensemble > 0 && objective >= 0 && atoi(args[3]) != 4){
+        cout << "--ensemble only combines with --optimize for Preemptive Random (4)" << endl;
+        return EXIT_FAILURE;
+    }
+    if(ensemble < 0 || (ensemble > 0 && stream)){
+        cout << "--ensemble needs a positive number of runs and can't be combined with --stream" << endl;
+        return EXIT_FAILURE;
+    }
+    if(pipeline && (stream || ensemble > 0)){
+        cout << "--pipeline can't be combined with --stream or --ensemble" << endl;
+        return EXIT_FAILURE;
+    }
+    if(objective >= 0 && !(atoi(args[3]) == 2 || atoi(args[3]) == 3 || atoi(args[3]) == 4)){
+        cout << "--optimize only applies to algorithms that take a time quantum (2, 3 and 4)" << endl;
+        return EXIT_FAILURE;
+    }
+    if(objective >= 0 && (stream || pipeline || telemetry > 0)){
+        cout << "--optimize can't be combined with --stream, --pipeline or --telemetry" << endl;
+        return EXIT_FAILURE;
+    }
+    if(!cachedir.empty() && (stream || ensemble > 0 || pipeline || telemetry > 0)){
+        cout << "--cache only applies to plain runs, not --stream, --ensemble, --pipeline or --telemetry" << endl;
+        return EXIT_FAILURE;
+    }
+    if(!whatifs.empty() && (stream || ensemble > 0 || pipeline || telemetry > 0 || objective >= 0 || !cachedir.empty())){
+        cout << "--whatif can't be combined with --stream, --ensemble, --pipeline, --telemetry, --optimize or --cache" << endl;
+        return EXIT_FAILURE;
+    }
+    if(unsorted && (pipeline || sort_memory <= 0)){
+        cout << "--unsorted needs a positive --sort-memory and can't be combined with --pipeline" << endl;
+        return EXIT_FAILURE;
+    }
+    if((trace && (unsorted || pipeline)) || (!trace_export.empty() && !trace)){
+        cout << "--trace can't be combined with --unsorted or --pipeline, and --trace-export needs --trace" << endl;
+        return EXIT_FAILURE;
+    }
+    if(gantt && (ensemble > 0 || objective >= 0 || !whatifs.empty() || !cachedir.empty())){
+        cout << "--gantt only applies to single runs, not --ensemble, --optimize, --whatif or --cache" << endl;
+        return EXIT_FAILURE;
+    }
+    if(spill && (stream || ensemble > 0 || pipeline || objective >= 0 || !whatifs.empty() || !cachedir.empty() || sort_memory <= 0)){
+        cout << "--spill needs a positive --sort-memory and can't be combined with --stream, --ensemble, --pipeline, --optimize, --whatif or --cache" << endl;
+        return EXIT_FAILURE;
+    }
+    if(batch && (stream || ensemble > 0 || pipeline || objective >= 0 || !whatifs.empty() || !cachedir.empty() || unsorted || trace || spill || telemetry_stream)){
+        cout << "--batch only applies to plain runs, not --stream, --ensemble, --pipeline, --optimize, --whatif, --cache, --unsorted, --trace, --spill or --telemetry-stream" << endl;
+        return EXIT_FAILURE;
+    }
+    if(cluster < 0 || window <= 0 || (cluster > 0 && (stream || ensemble > 0 || pipeline || objective >= 0 || !whatifs.empty() || !cachedir.empty() || spill || batch || telemetry > 0 || gantt))){
+        cout << "--cluster needs a positive number of machines and --window, and can't be combined with --stream, --ensemble, --pipeline, --optimize, --whatif, --cache, --spill, --batch, --telemetry or --gantt" << endl;
+        return EXIT_FAILURE;
+    }
+    if(!progress_socket.empty() && (ensemble > 0 || objective >= 0 || !whatifs.empty() || batch || cluster > 0)){
+        cout << "--progress-socket only applies to single runs, not --ensemble, --optimize, --whatif, --batch or --cluster" << endl;
+        return EXIT_FAILURE;
+    }
+    if(snapshot_every <= 0){
+        cout << "--snapshot-every needs a positive interval in ms" << endl;
+        return EXIT_FAILURE;
+    }
+
+    SimConfig config;
     //variables to hold initial arguments
-    int algorithm = atoi(argv[3]);
-    int timeq = -1;
+    config.algorithm = atoi(args[3]);
+    config.timeq = -1;
 
     // Account for algorithms 3 and 4 too - 3 is preemptive priority and 4 is preemptive random.
-    if(algorithm == 2 || algorithm == 3 || algorithm == 4) timeq = atoi(argv[4]);
+    if((config.algorithm == 2 || config.algorithm == 3 || config.algorithm == 4 || config.algorithm == 6 || config.algorithm == 7) && args.size() > 4) config.timeq = atoi(args[4]);
+    // the multi-level feedback queue takes its quanta from --levels, or doubles timeq at each of three levels.
+    config.levels = levels;
+    config.boost = boost;
 
-    // set the seed for the preemptive random algorithm.
-    srand(time(NULL));
+    // set the seed for the preemptive random algorithm, fixed with --seed to repeat a run.
+    config.seed = seeded ? seed : time(NULL);
 
-    //queues to hold PCBs throughout
-    auto ready_queue = new DList<PCB>();
-    auto finished_queue = new DList<PCB>();
+    config.outfile = args[2];
+    // In streaming mode each process's results go to stdout as soon as it finishes.
+    if(stream) config.stream = &cout;
 
-    // Create a new blocked queue too.
-    auto blocked_queue = new DList<PCB>();
+    // Telemetry rows are either collected and written at the end, or written as they are sampled.
+    config.telemetry = telemetry;
+    config.gantt = gantt;
+    std::ofstream telemetryfile;
+    if(telemetry > 0 && telemetry_stream){
+        telemetryfile.open(config.outfile + "-telemetry");
+        config.telemetry_stream = &telemetryfile;
+    }
 
-    // vector to store the process transitions.
-    vector<PCBStatus> lifeCycleVector;
+    // the counters cover every simulation this run did, whichever mode it was in.
+    auto reportmemory = [&](){
+        if(!memory) return;
+        std::ofstream memoryfile(config.outfile + "-memory");
+        MemoryStats::print(memoryfile);
+    };
+
+    // answers on the socket for as long as the run lasts, and removes it once main returns.
+    Progress progress;
 
     try {
-        // Acts as the CPU clock.
-        Clock clock;
-        // A process generator. Reads and parses every line of the input file. If their CPU clock >= arrival_time,
-        // the parsed PCB object is placed on the ready queue. 
-        PCBGenerator pgen(argv[1], ready_queue, &clock, &lifeCycleVector);
-        // A utility to update core statistics.
-        StatUpdater stats(ready_queue, finished_queue, &clock, algorithm, argv[2], timeq, &lifeCycleVector);
-        // The CPU simulation.
-        CPU cpu(finished_queue, &clock, &lifeCycleVector);
-        // The heart of the code. Switch between multiple algorithms and decide how the CPU will consume the
-        // processes from the ready queue.
-        Scheduler scheduler(ready_queue, &cpu, algorithm, timeq, &lifeCycleVector);
-        // Another vital utility that manages context switches.
-        Dispatcher dispatcher(&cpu, &scheduler, ready_queue, &clock, blocked_queue, &lifeCycleVector);
-        scheduler.setdispatcher(&dispatcher);
-
-        //loop will continue until no more processes are going to be generated,
-        // no more in ready queue, no more in blocked queue, and cpu is done
-        while (!pgen.finished() || ready_queue->size() || !cpu.isidle() || blocked_queue->size()) {
-            pgen.generate();
-            scheduler.execute();
-            dispatcher.execute();
-            cpu.execute();
-            serveIO(ready_queue, blocked_queue, &clock, &lifeCycleVector);
-            stats.execute();
-            clock.step();
-        }
-
-        //print stats when the simulation is done and the accumulator data structures have data.
-        stats.print();
-        stats.printProcessLifecycle();
-
-    }catch(int){
-        delete ready_queue;
-        delete finished_queue;
-        delete blocked_queue;
+        // shares and quotas per group, every group not listed gets 1024 shares and no quota.
+        if(!groupfile.empty()) config.groups = Groups::read(groupfile);
+
+        if(!progress_socket.empty()){
+            progress.listen(progress_socket);
+            config.progress = &progress;
+        }
+
+        if(batch){
+            // the input is a directory or manifest of inputs and the output a directory for their reports.
+            Batch inputs(args[1], config.outfile, config);
+            inputs.run();
+            int failed = inputs.print(config.outfile + "/summary");
+            reportmemory();
+            return failed > 0 ? EXIT_FAILURE : 0;
+        }
+
+        if(pipeline){
+            // parsing, simulating and writing the report each get their own thread.
+            Pipeline stages(4096);
+            stages.run(args[1], config.outfile, config);
+            reportmemory();
+            return 0;
+        }
+
+        // Reads and parses every line of the input file.
+        PCBReader reader(args[1]);
+        PCBSource *input = &reader;
+        // unsorted input is sorted by arrival first, spilling sorted runs to disk past --sort-memory MB.
+        size_t sortchunk = size_t(sort_memory * 1024 * 1024 / sizeof(PCB));
+        ArrivalSorter sorter(&reader, sortchunk, "");
+        if(unsorted){
+            reader.allowunsorted();
+            input = &sorter;
+        }
+        // finished processes go to disk, and duplicate pids are caught when they are sorted for the report.
+        if(spill){
+            reader.skippidcheck();
+            config.spill = sortchunk;
+        }
+        // a scheduler trace is turned into a workload instead of being read as records.
+        TraceImporter importer(args[1]);
+        if(trace){
+            input = &importer;
+            if(!trace_export.empty()){
+                std::ofstream exported(trace_export);
+                importer.write(exported);
+            }
+        }
+
+        if(cluster > 0){
+            // processes are placed on the machines as they arrive, only the cluster summary is written.
+            Cluster machines(cluster, config, Placement(placement), window);
+            machines.run(input);
+            machines.print(config.outfile);
+        }
+        else if(ensemble > 0 && objective < 0){
+            // parse once, every run in the ensemble replays the same copy.
+            std::vector<PCB> workload;
+            input->readall(workload);
+            Ensemble runs(&workload, config, ensemble);
+            runs.run();
+            runs.print(config.outfile);
+        }
+        else if(objective >= 0){
+            // parse once, every candidate quantum replays the same copy.
+            std::vector<PCB> workload;
+            input->readall(workload);
+            // for preemptive random, --ensemble k sets how many runs each quantum is averaged over.
+            QuantumOptimizer search(&workload, config, objective, qmax, ensemble);
+            search.run();
+            search.print(config.outfile);
+        }
+        else if(!whatifs.empty()){
+            // the baseline is simulated once, each changed workload resumes from one of its snapshots.
+            std::vector<PCB> workload;
+            input->readall(workload);
+            WhatIf tuner(&workload, config, snapshot_every);
+            tuner.run();
+            int count = 0;
+            auto compare = [&](const std::string &path){
+                if(!std::ifstream(path)) throw SimError("Can't open " + path + ".");
+                std::vector<PCB> changed;
+                PCBReader changedreader(path);
+                if(unsorted){
+                    changedreader.allowunsorted();
+                    ArrivalSorter(&changedreader, sortchunk, "").readall(changed);
+                }
+                else changedreader.readall(changed);
+                SimResults results;
+                float resumed = tuner.compare(changed, results);
+                std::string out = config.outfile + "-whatif" + std::to_string(++count);
+                tuner.print(out, results, resumed);
+                return out;
+            };
+            for(size_t i = 0; i < whatifs.size(); ++i){
+                if(whatifs[i] != "-"){
+                    compare(whatifs[i]);
+                    continue;
+                }
+                // a path of - reads more paths from stdin, one per line, until it closes.
+                // a bad file only skips that one.
+                std::string line;
+                while(std::getline(cin, line)){
+                    if(line.empty()) continue;
+                    try {
+                        cout << compare(line) << endl;
+                    }catch(SimError &e){
+                        cout << e.what() << endl;
+                    }
+                }
+            }
+        }
+        else if(!cachedir.empty()){
+            // the key is over the parsed workload, so formatting differences in the file don't matter.
+            std::vector<PCB> workload;
+            input->readall(workload);
+            ResultCache cache(cachedir);
+            std::string key = ResultCache::key(workload, config);
+            if(!cache.fetch(key, config.outfile)){
+                Simulator sim;
+                SimResults results;
+                WorkloadSource src(&workload);
+                sim.run(&src, config, results);
+                cache.store(key, config.outfile);
+            }
+        }
+        else {
+            Simulator sim;
+            SimResults results;
+            sim.run(input, config, results);
+        }
+
+    }catch(SimError &e){
+        cout << e.what() << " Exiting now." << endl;
         return EXIT_FAILURE;
     }
 
+    reportmemory();
     return 0;
-}
\ No newline at end of file
+}